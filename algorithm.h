@@ -0,0 +1,604 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _ALGORITHM_H_
+#define _ALGORITHM_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "sequence.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) && defined(__GNUC__)
+#define _TOOLS_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Scans over contiguous ranges: find, count, min_value, max_value, sum
+ * and all_less. They take pointer ranges or a whole sequence. int32_t
+ * and float ranges run SSE2 or AVX2 kernels, picked once at runtime
+ * from CPUID; other types and other targets use the scalar loops.
+ *
+ * float sums are accumulated in double, lane by lane, so they may
+ * differ from a left-to-right float loop in the last bits.
+ */
+
+namespace tools {
+
+	enum simd_level {
+		simd_scalar,
+		simd_sse2,
+		simd_avx2
+	};
+
+	inline simd_level detected_simd_level() {
+#ifdef _TOOLS_SIMD_X86
+		static const simd_level level = [] {
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2") ? simd_avx2 : simd_sse2;
+		}();
+		return level;
+#else
+		return simd_scalar;
+#endif
+	}
+
+	inline simd_level& _active_simd_level() {
+		static simd_level level = detected_simd_level();
+		return level;
+	}
+
+	inline simd_level active_simd_level() { return _active_simd_level(); }
+
+	/* caps the kernels in use, e.g. to compare them; never above what the cpu has */
+	inline void set_simd_level(simd_level level) {
+		simd_level detected = detected_simd_level();
+		_active_simd_level() = level < detected ? level : detected;
+	}
+
+	template <typename _T>
+	struct _same_type {
+		typedef _T type;
+	};
+
+	template <typename _T>
+	struct _sum_type {
+		typedef _T type;
+	};
+
+	template <>
+	struct _sum_type<int32_t> {
+		typedef int64_t type;
+	};
+
+	template <>
+	struct _sum_type<float> {
+		typedef double type;
+	};
+
+	/* scalar loops, the reference for the kernels below */
+
+	template <typename _T>
+	inline const _T* _find_scalar(const _T* first, const _T* last, const _T& value) {
+		for (; first != last; ++first) {
+			if (*first == value) {
+				break;
+			}
+		}
+		return first;
+	}
+
+	template <typename _T>
+	inline size_t _count_scalar(const _T* first, const _T* last, const _T& value) {
+		size_t n = 0;
+		for (; first != last; ++first) {
+			n += *first == value;
+		}
+		return n;
+	}
+
+	template <typename _T>
+	inline _T _min_scalar(const _T* first, const _T* last, _T result) {
+		for (; first != last; ++first) {
+			if (*first < result) {
+				result = *first;
+			}
+		}
+		return result;
+	}
+
+	template <typename _T>
+	inline _T _max_scalar(const _T* first, const _T* last, _T result) {
+		for (; first != last; ++first) {
+			if (result < *first) {
+				result = *first;
+			}
+		}
+		return result;
+	}
+
+	template <typename _T>
+	inline typename _sum_type<_T>::type
+		_sum_scalar(const _T* first, const _T* last, typename _sum_type<_T>::type result) {
+		for (; first != last; ++first) {
+			result += *first;
+		}
+		return result;
+	}
+
+	template <typename _T>
+	inline bool _all_less_scalar(const _T* first, const _T* last, const _T& bound) {
+		for (; first != last; ++first) {
+			if (!(*first < bound)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+#ifdef _TOOLS_SIMD_X86
+
+	/* SSE2, the x86-64 baseline, 4 lanes */
+
+	inline const int32_t* _find_sse2(const int32_t* first, const int32_t* last, int32_t value) {
+		const __m128i key = _mm_set1_epi32(value);
+		for (; 4 <= last - first; first += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i*) first);
+			int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, key)));
+			if (0 != mask) {
+				return first + __builtin_ctz(mask);
+			}
+		}
+		return _find_scalar(first, last, value);
+	}
+
+	inline const float* _find_sse2(const float* first, const float* last, float value) {
+		const __m128 key = _mm_set1_ps(value);
+		for (; 4 <= last - first; first += 4) {
+			int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(first), key));
+			if (0 != mask) {
+				return first + __builtin_ctz(mask);
+			}
+		}
+		return _find_scalar(first, last, value);
+	}
+
+	inline size_t _count_sse2(const int32_t* first, const int32_t* last, int32_t value) {
+		const __m128i key = _mm_set1_epi32(value);
+		size_t n = 0;
+		for (; 4 <= last - first; first += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i*) first);
+			n += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, key))));
+		}
+		return n + _count_scalar(first, last, value);
+	}
+
+	inline size_t _count_sse2(const float* first, const float* last, float value) {
+		const __m128 key = _mm_set1_ps(value);
+		size_t n = 0;
+		for (; 4 <= last - first; first += 4) {
+			n += __builtin_popcount(_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(first), key)));
+		}
+		return n + _count_scalar(first, last, value);
+	}
+
+	/* SSE2 has no pminsd/pmaxsd, select through a compare mask */
+	inline int32_t _min_sse2(const int32_t* first, const int32_t* last, int32_t result) {
+		__m128i acc = _mm_set1_epi32(result);
+		for (; 4 <= last - first; first += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i*) first);
+			__m128i smaller = _mm_cmplt_epi32(v, acc);
+			acc = _mm_or_si128(_mm_and_si128(smaller, v), _mm_andnot_si128(smaller, acc));
+		}
+		int32_t lanes[4];
+		_mm_storeu_si128((__m128i*) lanes, acc);
+		return _min_scalar(first, last, _min_scalar(lanes, lanes + 4, result));
+	}
+
+	inline int32_t _max_sse2(const int32_t* first, const int32_t* last, int32_t result) {
+		__m128i acc = _mm_set1_epi32(result);
+		for (; 4 <= last - first; first += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i*) first);
+			__m128i larger = _mm_cmpgt_epi32(v, acc);
+			acc = _mm_or_si128(_mm_and_si128(larger, v), _mm_andnot_si128(larger, acc));
+		}
+		int32_t lanes[4];
+		_mm_storeu_si128((__m128i*) lanes, acc);
+		return _max_scalar(first, last, _max_scalar(lanes, lanes + 4, result));
+	}
+
+	/* minps returns its second operand on NaN, so NaNs in the range are skipped */
+	inline float _min_sse2(const float* first, const float* last, float result) {
+		__m128 acc = _mm_set1_ps(result);
+		for (; 4 <= last - first; first += 4) {
+			acc = _mm_min_ps(_mm_loadu_ps(first), acc);
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, acc);
+		return _min_scalar(first, last, _min_scalar(lanes, lanes + 4, result));
+	}
+
+	inline float _max_sse2(const float* first, const float* last, float result) {
+		__m128 acc = _mm_set1_ps(result);
+		for (; 4 <= last - first; first += 4) {
+			acc = _mm_max_ps(_mm_loadu_ps(first), acc);
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, acc);
+		return _max_scalar(first, last, _max_scalar(lanes, lanes + 4, result));
+	}
+
+	inline int64_t _sum_sse2(const int32_t* first, const int32_t* last) {
+		__m128i acc = _mm_setzero_si128();
+		for (; 4 <= last - first; first += 4) {
+			__m128i v    = _mm_loadu_si128((const __m128i*) first);
+			__m128i sign = _mm_srai_epi32(v, 31);
+			acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+			acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+		}
+		int64_t lanes[2];
+		_mm_storeu_si128((__m128i*) lanes, acc);
+		return _sum_scalar(first, last, lanes[0] + lanes[1]);
+	}
+
+	inline double _sum_sse2(const float* first, const float* last) {
+		__m128d acc = _mm_setzero_pd();
+		for (; 4 <= last - first; first += 4) {
+			__m128 v = _mm_loadu_ps(first);
+			acc = _mm_add_pd(acc, _mm_cvtps_pd(v));
+			acc = _mm_add_pd(acc, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+		}
+		double lanes[2];
+		_mm_storeu_pd(lanes, acc);
+		return _sum_scalar(first, last, lanes[0] + lanes[1]);
+	}
+
+	inline bool _all_less_sse2(const int32_t* first, const int32_t* last, int32_t bound) {
+		const __m128i key = _mm_set1_epi32(bound);
+		for (; 4 <= last - first; first += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i*) first);
+			if (0xF != _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, key)))) {
+				return false;
+			}
+		}
+		return _all_less_scalar(first, last, bound);
+	}
+
+	inline bool _all_less_sse2(const float* first, const float* last, float bound) {
+		const __m128 key = _mm_set1_ps(bound);
+		for (; 4 <= last - first; first += 4) {
+			if (0xF != _mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(first), key))) {
+				return false;
+			}
+		}
+		return _all_less_scalar(first, last, bound);
+	}
+
+	/* AVX2, 8 lanes, only called once CPUID reported it */
+
+#define _TOOLS_AVX2 __attribute__((target("avx2")))
+
+	_TOOLS_AVX2
+	inline const int32_t* _find_avx2(const int32_t* first, const int32_t* last, int32_t value) {
+		const __m256i key = _mm256_set1_epi32(value);
+		for (; 8 <= last - first; first += 8) {
+			__m256i v = _mm256_loadu_si256((const __m256i*) first);
+			int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, key)));
+			if (0 != mask) {
+				return first + __builtin_ctz(mask);
+			}
+		}
+		return _find_scalar(first, last, value);
+	}
+
+	_TOOLS_AVX2
+	inline const float* _find_avx2(const float* first, const float* last, float value) {
+		const __m256 key = _mm256_set1_ps(value);
+		for (; 8 <= last - first; first += 8) {
+			int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(first), key, _CMP_EQ_OQ));
+			if (0 != mask) {
+				return first + __builtin_ctz(mask);
+			}
+		}
+		return _find_scalar(first, last, value);
+	}
+
+	_TOOLS_AVX2
+	inline size_t _count_avx2(const int32_t* first, const int32_t* last, int32_t value) {
+		const __m256i key = _mm256_set1_epi32(value);
+		size_t n = 0;
+		for (; 8 <= last - first; first += 8) {
+			__m256i v = _mm256_loadu_si256((const __m256i*) first);
+			n += __builtin_popcount(
+				_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, key)))
+			);
+		}
+		return n + _count_scalar(first, last, value);
+	}
+
+	_TOOLS_AVX2
+	inline size_t _count_avx2(const float* first, const float* last, float value) {
+		const __m256 key = _mm256_set1_ps(value);
+		size_t n = 0;
+		for (; 8 <= last - first; first += 8) {
+			n += __builtin_popcount(
+				_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(first), key, _CMP_EQ_OQ))
+			);
+		}
+		return n + _count_scalar(first, last, value);
+	}
+
+	_TOOLS_AVX2
+	inline int32_t _min_avx2(const int32_t* first, const int32_t* last, int32_t result) {
+		__m256i acc = _mm256_set1_epi32(result);
+		for (; 8 <= last - first; first += 8) {
+			acc = _mm256_min_epi32(acc, _mm256_loadu_si256((const __m256i*) first));
+		}
+		int32_t lanes[8];
+		_mm256_storeu_si256((__m256i*) lanes, acc);
+		return _min_scalar(first, last, _min_scalar(lanes, lanes + 8, result));
+	}
+
+	_TOOLS_AVX2
+	inline int32_t _max_avx2(const int32_t* first, const int32_t* last, int32_t result) {
+		__m256i acc = _mm256_set1_epi32(result);
+		for (; 8 <= last - first; first += 8) {
+			acc = _mm256_max_epi32(acc, _mm256_loadu_si256((const __m256i*) first));
+		}
+		int32_t lanes[8];
+		_mm256_storeu_si256((__m256i*) lanes, acc);
+		return _max_scalar(first, last, _max_scalar(lanes, lanes + 8, result));
+	}
+
+	_TOOLS_AVX2
+	inline float _min_avx2(const float* first, const float* last, float result) {
+		__m256 acc = _mm256_set1_ps(result);
+		for (; 8 <= last - first; first += 8) {
+			acc = _mm256_min_ps(_mm256_loadu_ps(first), acc);
+		}
+		float lanes[8];
+		_mm256_storeu_ps(lanes, acc);
+		return _min_scalar(first, last, _min_scalar(lanes, lanes + 8, result));
+	}
+
+	_TOOLS_AVX2
+	inline float _max_avx2(const float* first, const float* last, float result) {
+		__m256 acc = _mm256_set1_ps(result);
+		for (; 8 <= last - first; first += 8) {
+			acc = _mm256_max_ps(_mm256_loadu_ps(first), acc);
+		}
+		float lanes[8];
+		_mm256_storeu_ps(lanes, acc);
+		return _max_scalar(first, last, _max_scalar(lanes, lanes + 8, result));
+	}
+
+	_TOOLS_AVX2
+	inline int64_t _sum_avx2(const int32_t* first, const int32_t* last) {
+		__m256i acc = _mm256_setzero_si256();
+		for (; 8 <= last - first; first += 8) {
+			__m256i v = _mm256_loadu_si256((const __m256i*) first);
+			acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+			acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+		}
+		int64_t lanes[4];
+		_mm256_storeu_si256((__m256i*) lanes, acc);
+		return _sum_scalar(first, last, lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+	}
+
+	_TOOLS_AVX2
+	inline double _sum_avx2(const float* first, const float* last) {
+		__m256d acc = _mm256_setzero_pd();
+		for (; 8 <= last - first; first += 8) {
+			__m256 v = _mm256_loadu_ps(first);
+			acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+			acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+		}
+		double lanes[4];
+		_mm256_storeu_pd(lanes, acc);
+		return _sum_scalar(first, last, lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+	}
+
+	_TOOLS_AVX2
+	inline bool _all_less_avx2(const int32_t* first, const int32_t* last, int32_t bound) {
+		const __m256i key = _mm256_set1_epi32(bound);
+		for (; 8 <= last - first; first += 8) {
+			__m256i v = _mm256_loadu_si256((const __m256i*) first);
+			if (0xFF != _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(key, v)))) {
+				return false;
+			}
+		}
+		return _all_less_scalar(first, last, bound);
+	}
+
+	_TOOLS_AVX2
+	inline bool _all_less_avx2(const float* first, const float* last, float bound) {
+		const __m256 key = _mm256_set1_ps(bound);
+		for (; 8 <= last - first; first += 8) {
+			if (0xFF != _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(first), key, _CMP_LT_OQ))) {
+				return false;
+			}
+		}
+		return _all_less_scalar(first, last, bound);
+	}
+
+#undef _TOOLS_AVX2
+
+	/* runtime dispatch for the types with kernels */
+
+	template <typename _T>
+	struct _has_simd_kernels : _false_type { };
+
+	template <>
+	struct _has_simd_kernels<int32_t> : _true_type { };
+
+	template <>
+	struct _has_simd_kernels<float> : _true_type { };
+
+	template <typename _T>
+	inline const _T* _find(const _T* first, const _T* last, const _T& value, _true_type) {
+		switch (active_simd_level()) {
+			case simd_avx2: return _find_avx2(first, last, value);
+			case simd_sse2: return _find_sse2(first, last, value);
+			default:        return _find_scalar(first, last, value);
+		}
+	}
+
+	template <typename _T>
+	inline size_t _count(const _T* first, const _T* last, const _T& value, _true_type) {
+		switch (active_simd_level()) {
+			case simd_avx2: return _count_avx2(first, last, value);
+			case simd_sse2: return _count_sse2(first, last, value);
+			default:        return _count_scalar(first, last, value);
+		}
+	}
+
+	template <typename _T>
+	inline _T _min(const _T* first, const _T* last, _true_type) {
+		switch (active_simd_level()) {
+			case simd_avx2: return _min_avx2(first + 1, last, *first);
+			case simd_sse2: return _min_sse2(first + 1, last, *first);
+			default:        return _min_scalar(first + 1, last, *first);
+		}
+	}
+
+	template <typename _T>
+	inline _T _max(const _T* first, const _T* last, _true_type) {
+		switch (active_simd_level()) {
+			case simd_avx2: return _max_avx2(first + 1, last, *first);
+			case simd_sse2: return _max_sse2(first + 1, last, *first);
+			default:        return _max_scalar(first + 1, last, *first);
+		}
+	}
+
+	template <typename _T>
+	inline typename _sum_type<_T>::type _sum(const _T* first, const _T* last, _true_type) {
+		switch (active_simd_level()) {
+			case simd_avx2: return _sum_avx2(first, last);
+			case simd_sse2: return _sum_sse2(first, last);
+			default:        return _sum_scalar(first, last, typename _sum_type<_T>::type());
+		}
+	}
+
+	template <typename _T>
+	inline bool _all_less(const _T* first, const _T* last, const _T& bound, _true_type) {
+		switch (active_simd_level()) {
+			case simd_avx2: return _all_less_avx2(first, last, bound);
+			case simd_sse2: return _all_less_sse2(first, last, bound);
+			default:        return _all_less_scalar(first, last, bound);
+		}
+	}
+
+#else
+
+	template <typename _T>
+	struct _has_simd_kernels : _false_type { };
+
+#endif //_TOOLS_SIMD_X86
+
+	template <typename _T>
+	inline const _T* _find(const _T* first, const _T* last, const _T& value, _false_type) {
+		return _find_scalar(first, last, value);
+	}
+
+	template <typename _T>
+	inline size_t _count(const _T* first, const _T* last, const _T& value, _false_type) {
+		return _count_scalar(first, last, value);
+	}
+
+	template <typename _T>
+	inline _T _min(const _T* first, const _T* last, _false_type) {
+		return _min_scalar(first + 1, last, *first);
+	}
+
+	template <typename _T>
+	inline _T _max(const _T* first, const _T* last, _false_type) {
+		return _max_scalar(first + 1, last, *first);
+	}
+
+	template <typename _T>
+	inline typename _sum_type<_T>::type _sum(const _T* first, const _T* last, _false_type) {
+		return _sum_scalar(first, last, typename _sum_type<_T>::type());
+	}
+
+	template <typename _T>
+	inline bool _all_less(const _T* first, const _T* last, const _T& bound, _false_type) {
+		return _all_less_scalar(first, last, bound);
+	}
+
+	/* pointer ranges */
+
+	template <typename _T>
+	inline const _T* find(const _T* first, const _T* last, const typename _same_type<_T>::type& value) {
+		return _find(first, last, value, _has_simd_kernels<_T>());
+	}
+
+	template <typename _T>
+	inline size_t count(const _T* first, const _T* last, const typename _same_type<_T>::type& value) {
+		return _count(first, last, value, _has_simd_kernels<_T>());
+	}
+
+	/* the range must not be empty */
+	template <typename _T>
+	inline _T min_value(const _T* first, const _T* last) {
+		assert(first != last);
+		return _min(first, last, _has_simd_kernels<_T>());
+	}
+
+	template <typename _T>
+	inline _T max_value(const _T* first, const _T* last) {
+		assert(first != last);
+		return _max(first, last, _has_simd_kernels<_T>());
+	}
+
+	/* int32_t sums to int64_t, float to double */
+	template <typename _T>
+	inline typename _sum_type<_T>::type sum(const _T* first, const _T* last) {
+		return _sum(first, last, _has_simd_kernels<_T>());
+	}
+
+	template <typename _T>
+	inline bool all_less(const _T* first, const _T* last, const typename _same_type<_T>::type& bound) {
+		return _all_less(first, last, bound, _has_simd_kernels<_T>());
+	}
+
+	/* whole sequences */
+
+	template <typename _T, typename _Allocator, typename _Growth>
+	inline typename sequence<_T, _Allocator, _Growth>::const_iterator
+		find(const sequence<_T, _Allocator, _Growth>& seq, const typename _same_type<_T>::type& value) {
+		typedef typename sequence<_T, _Allocator, _Growth>::const_iterator const_iterator;
+		return const_iterator(find(seq.data(), seq.data() + seq.size(), value));
+	}
+
+	template <typename _T, typename _Allocator, typename _Growth>
+	inline size_t count(const sequence<_T, _Allocator, _Growth>& seq,
+	                    const typename _same_type<_T>::type& value) {
+		return count(seq.data(), seq.data() + seq.size(), value);
+	}
+
+	template <typename _T, typename _Allocator, typename _Growth>
+	inline _T min_value(const sequence<_T, _Allocator, _Growth>& seq) {
+		return min_value(seq.data(), seq.data() + seq.size());
+	}
+
+	template <typename _T, typename _Allocator, typename _Growth>
+	inline _T max_value(const sequence<_T, _Allocator, _Growth>& seq) {
+		return max_value(seq.data(), seq.data() + seq.size());
+	}
+
+	template <typename _T, typename _Allocator, typename _Growth>
+	inline typename _sum_type<_T>::type sum(const sequence<_T, _Allocator, _Growth>& seq) {
+		return sum(seq.data(), seq.data() + seq.size());
+	}
+
+	template <typename _T, typename _Allocator, typename _Growth>
+	inline bool all_less(const sequence<_T, _Allocator, _Growth>& seq,
+	                     const typename _same_type<_T>::type& bound) {
+		return all_less(seq.data(), seq.data() + seq.size(), bound);
+	}
+}
+
+#endif //_ALGORITHM_H_
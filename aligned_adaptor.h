@@ -0,0 +1,74 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _ALIGNED_ADAPTOR_H_
+#define _ALIGNED_ADAPTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "memory.h"
+
+namespace tools {
+
+	/*
+	 * Wraps another allocator so every block starts on an _Align byte
+	 * boundary, e.g. sequence<float, aligned_adaptor<64>>. The upstream
+	 * block is over-allocated and its address is kept just in front of
+	 * the aligned one. Since sequence reallocates through its allocator,
+	 * the alignment survives growth.
+	 */
+	template <
+		size_t   _Align,
+		typename _Alloc = std::allocator<char>
+	>
+	class aligned_adaptor : private _byte_allocator<_Alloc>::type {
+		static_assert(0 == (_Align & (_Align - 1)), "alignment must be a power of two");
+		static_assert(sizeof (void*) <= _Align, "alignment must hold a pointer");
+
+	protected:
+		typedef typename _byte_allocator<_Alloc>::type upstream_type;
+
+	public:
+		enum { alignment = _Align };
+
+	private:
+		static size_t _padded(size_t n) { return n + _Align + sizeof (void*) - 1; }
+
+		upstream_type& _upstream() { return *this; }
+
+	public:
+		aligned_adaptor() = default;
+		explicit aligned_adaptor(const _Alloc& upstream) : upstream_type(upstream) { }
+
+	public:
+		void* allocate(size_t n) {
+			char* raw = (char*) _upstream().allocate(_padded(n));
+			uintptr_t aligned =
+				((uintptr_t) raw + sizeof (void*) + _Align - 1) & ~uintptr_t(_Align - 1);
+			((void**) aligned)[-1] = raw;
+			return (void*) aligned;
+		}
+
+		void deallocate(void* p, size_t n) {
+			if (nullptr == p) {
+				return;
+			}
+			_upstream().deallocate((char*) ((void**) p)[-1], _padded(n));
+		}
+
+		_Alloc upstream() const { return _Alloc((const upstream_type&) *this); }
+	};
+
+	template <size_t _Align, typename _Alloc>
+	struct _is_monotonic_alloc<aligned_adaptor<_Align, _Alloc>> : _is_monotonic_alloc<_Alloc> { };
+
+	template <size_t _Align>
+	inline bool is_aligned(const void* p) {
+		return 0 == ((uintptr_t) p & (_Align - 1));
+	}
+}
+
+#endif //_ALIGNED_ADAPTOR_H_
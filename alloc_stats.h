@@ -0,0 +1,200 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _ALLOC_STATS_H_
+#define _ALLOC_STATS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#include "memory.h"
+
+namespace tools {
+
+	enum { _alloc_histogram_buckets = sizeof (size_t) * 8 };
+
+	/* bucket i counts allocations of [2^i, 2^(i+1)) bytes */
+	struct alloc_stats_snapshot {
+		const char* name;
+		size_t      allocations;
+		size_t      deallocations;
+		size_t      live_bytes;
+		size_t      peak_bytes;
+		size_t      histogram[_alloc_histogram_buckets];
+	};
+
+	class _alloc_stats_record {
+	private:
+		const char*          m_name;
+		_alloc_stats_record* m_next;
+
+		std::atomic<size_t> m_allocations;
+		std::atomic<size_t> m_deallocations;
+		std::atomic<size_t> m_live_bytes;
+		std::atomic<size_t> m_peak_bytes;
+		std::atomic<size_t> m_histogram[_alloc_histogram_buckets];
+
+	private:
+		static size_t _bucket_of(size_t bytes) {
+			return 0 == bytes ? 0 : sizeof (size_t) * 8 - 1 - __builtin_clzl(bytes);
+		}
+
+		static std::mutex& _registry_lock() {
+			static std::mutex lock;
+			return lock;
+		}
+
+		static _alloc_stats_record*& _registry() {
+			static _alloc_stats_record* head = nullptr;
+			return head;
+		}
+
+	public:
+		explicit _alloc_stats_record(const char* name) :
+			m_name(name), m_next(nullptr),
+			m_allocations(0), m_deallocations(0),
+			m_live_bytes(0), m_peak_bytes(0) {
+			for (size_t i = 0; i < _alloc_histogram_buckets; ++i) {
+				m_histogram[i].store(0, std::memory_order_relaxed);
+			}
+
+			std::lock_guard<std::mutex> guard(_registry_lock());
+			m_next = _registry();
+			_registry() = this;
+		}
+
+		_alloc_stats_record(const _alloc_stats_record&) = delete;
+		_alloc_stats_record& operator=(const _alloc_stats_record&) = delete;
+
+	public:
+		void on_allocate(size_t bytes) {
+			m_allocations.fetch_add(1, std::memory_order_relaxed);
+			m_histogram[_bucket_of(bytes)].fetch_add(1, std::memory_order_relaxed);
+
+			size_t live = m_live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+			size_t peak = m_peak_bytes.load(std::memory_order_relaxed);
+			while (peak < live &&
+			       !m_peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+		}
+
+		void on_deallocate(size_t bytes) {
+			m_deallocations.fetch_add(1, std::memory_order_relaxed);
+			m_live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+		}
+
+		alloc_stats_snapshot snapshot() const {
+			alloc_stats_snapshot result;
+			result.name          = m_name;
+			result.allocations   = m_allocations.load(std::memory_order_relaxed);
+			result.deallocations = m_deallocations.load(std::memory_order_relaxed);
+			result.live_bytes    = m_live_bytes.load(std::memory_order_relaxed);
+			result.peak_bytes    = m_peak_bytes.load(std::memory_order_relaxed);
+			for (size_t i = 0; i < _alloc_histogram_buckets; ++i) {
+				result.histogram[i] = m_histogram[i].load(std::memory_order_relaxed);
+			}
+			return result;
+		}
+
+		/* one snapshot per tag used so far */
+		static std::vector<alloc_stats_snapshot> snapshot_all() {
+			std::vector<alloc_stats_snapshot> result;
+			std::lock_guard<std::mutex> guard(_registry_lock());
+			for (_alloc_stats_record* p = _registry(); nullptr != p; p = p->m_next) {
+				result.push_back(p->snapshot());
+			}
+			return result;
+		}
+	};
+
+	/* alloc_stats_adaptor policies, _Owner is the tag of the container */
+
+	struct _null_alloc_policy {
+		template <typename _Owner>
+		static void on_allocate(size_t) { }
+
+		template <typename _Owner>
+		static void on_deallocate(size_t) { }
+	};
+
+	struct alloc_stats_policy {
+		template <typename _Owner>
+		static _alloc_stats_record& record() {
+			static _alloc_stats_record instance(typeid (_Owner).name());
+			return instance;
+		}
+
+		template <typename _Owner>
+		static void on_allocate(size_t bytes) { record<_Owner>().on_allocate(bytes); }
+
+		template <typename _Owner>
+		static void on_deallocate(size_t bytes) { record<_Owner>().on_deallocate(bytes); }
+	};
+
+	/*
+	 * Wraps another allocator so _Policy sees every block a container
+	 * takes and gives back, e.g. sequence<order, alloc_stats_adaptor<
+	 * orders_tag>> with orders_tag any complete type. Containers sharing
+	 * a _Tag share a record, tag each one that should be counted apart.
+	 * Other containers are not touched, and with _null_alloc_policy the
+	 * adaptor compiles down to the allocator it wraps. Blocks are handed
+	 * back one by one even on a monotonic upstream, so live bytes stay
+	 * true.
+	 */
+	template <
+		typename _Tag,
+		typename _Alloc  = std::allocator<char>,
+		typename _Policy = alloc_stats_policy
+	>
+	class alloc_stats_adaptor : private _byte_allocator<_Alloc>::type {
+	protected:
+		typedef typename _byte_allocator<_Alloc>::type upstream_type;
+
+	private:
+		upstream_type& _upstream() { return *this; }
+		const upstream_type& _upstream() const { return *this; }
+
+	public:
+		alloc_stats_adaptor() = default;
+		explicit alloc_stats_adaptor(const _Alloc& upstream) : upstream_type(upstream) { }
+
+	public:
+		void* allocate(size_t n) {
+			void* p = _upstream().allocate(n);
+			_Policy::template on_allocate<_Tag>(n);
+			return p;
+		}
+
+		void deallocate(void* p, size_t n) {
+			_Policy::template on_deallocate<_Tag>(n);
+			_upstream().deallocate((char*) p, n);
+		}
+
+		/* only there when the upstream can resize blocks itself */
+		template <
+			typename _U = upstream_type,
+			typename = typename std::enable_if<_alloc_can_reallocate<_U>::value>::type
+		>
+		void* reallocate(void* p, size_t old_n, size_t new_n) {
+			void* q = _upstream().reallocate(p, old_n, new_n);
+			_Policy::template on_deallocate<_Tag>(old_n);
+			_Policy::template on_allocate<_Tag>(new_n);
+			return q;
+		}
+
+		size_t good_size(size_t n) const { return _alloc_good_size<upstream_type>::get(_upstream(), n); }
+
+		_Alloc upstream() const { return _Alloc(_upstream()); }
+	};
+
+	inline std::vector<alloc_stats_snapshot> alloc_stats() {
+		return _alloc_stats_record::snapshot_all();
+	}
+}
+
+#endif //_ALLOC_STATS_H_
@@ -0,0 +1,169 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "memory.h"
+#include "type_base.h"
+
+namespace tools {
+
+	/*
+	 * Monotonic region: allocate bumps a pointer inside the current chunk,
+	 * deallocate does nothing and release hands every chunk back at once.
+	 * Chunks double in size, so a region sized up front is a single malloc
+	 * and a single free.
+	 */
+	class arena {
+	public:
+		enum {
+			_align         = 16,
+			_default_chunk = 64 * 1024
+		};
+
+	private:
+		struct _chunk {
+			_chunk* prev;
+			size_t  size;
+		};
+
+		_chunk* m_chunks;
+		char*   m_cursor;
+		char*   m_limit;
+		size_t  m_next_size;
+
+	private:
+		static size_t _round_up(size_t n) {
+			return (n + _align - 1) & ~size_t(_align - 1);
+		}
+
+		static size_t _header_size() { return _round_up(sizeof (_chunk)); }
+
+		void _grow(size_t n) {
+			size_t size = _header_size() + n;
+			if (size < m_next_size) {
+				size = m_next_size;
+			}
+
+			_chunk* chunk = (_chunk*) std::malloc(size);
+			if (nullptr == chunk) {
+				throw std::bad_alloc();
+			}
+
+			chunk->prev = m_chunks;
+			chunk->size = size;
+			m_chunks = chunk;
+
+			m_cursor = (char*) chunk + _header_size();
+			m_limit  = (char*) chunk + size;
+			m_next_size = size * 2;
+		}
+
+	public:
+		explicit arena(size_t initial_size = _default_chunk) :
+			m_chunks(nullptr), m_cursor(nullptr), m_limit(nullptr),
+			m_next_size(_header_size() + _round_up(initial_size)) { }
+
+		arena(const arena&) = delete;
+		arena& operator=(const arena&) = delete;
+
+		~arena() { release(); }
+
+	public:
+		void* allocate(size_t n) {
+			n = _round_up(0 == n ? 1 : n);
+			if (size_t(m_limit - m_cursor) < n) {
+				_grow(n);
+			}
+
+			void* result = m_cursor;
+			m_cursor += n;
+			return result;
+		}
+
+		void deallocate(void*, size_t) { }
+
+		size_t good_size(size_t n) const { return _round_up(0 == n ? 1 : n); }
+
+		void release() {
+			while (nullptr != m_chunks) {
+				_chunk* prev = m_chunks->prev;
+				std::free(m_chunks);
+				m_chunks = prev;
+			}
+			m_cursor = nullptr;
+			m_limit  = nullptr;
+		}
+
+		size_t capacity() const {
+			size_t total = 0;
+			for (_chunk* p = m_chunks; nullptr != p; p = p->prev) {
+				total += p->size;
+			}
+			return total;
+		}
+
+	public:
+		/* binds an arena as the current region of this thread */
+		class scope {
+		private:
+			arena* m_previous;
+
+		public:
+			explicit scope(arena& region) : m_previous(current()) { current() = &region; }
+			~scope() { current() = m_previous; }
+
+			scope(const scope&) = delete;
+			scope& operator=(const scope&) = delete;
+		};
+
+		static arena*& current() {
+			static thread_local arena* region = nullptr;
+			return region;
+		}
+	};
+
+	/*
+	 * _Allocator for the containers. Bound to one arena for its whole
+	 * life: the one given, or when default constructed the arena of the
+	 * innermost arena::scope of the calling thread at that moment (throws
+	 * std::bad_alloc outside any scope). A container therefore keeps
+	 * every node in the arena it was built in, whatever scope it later
+	 * grows under. The region must outlive every container built on it.
+	 */
+	class arena_alloc {
+	private:
+		arena* m_region;
+
+	public:
+		arena_alloc() : m_region(arena::current()) {
+			if (nullptr == m_region) {
+				throw std::bad_alloc();
+			}
+		}
+
+		arena_alloc(arena& region) : m_region(&region) { }
+
+	public:
+		void* allocate(size_t n) { return m_region->allocate(n); }
+
+		void deallocate(void*, size_t) { }
+
+		size_t good_size(size_t n) const {
+			return ((0 == n ? 1 : n) + arena::_align - 1) & ~size_t(arena::_align - 1);
+		}
+
+		arena* region() const { return m_region; }
+	};
+
+	template <>
+	struct _is_monotonic_alloc<arena_alloc> : _true_type { };
+}
+
+#endif //_ARENA_H_
@@ -61,7 +61,7 @@ namespace tools {
 		typename _Comparator = less<_Key>,
 		typename _Allocator  = std::allocator<_avl_tree_node<_Val>>
 	>
-	class _avl_tree {
+	class _avl_tree : private standard_alloc<_avl_tree_node<_Val>, _Allocator> {
 	protected:
 		typedef _avl_tree_node<_Val>                    node_type;
 		typedef node_type*                              link_type;
@@ -103,9 +103,9 @@ namespace tools {
 		comparator_type m_comp;
 
 	protected:
-		link_type& root() const { return (link_type&) m_header->parent; }
-		link_type& leftmost() const { return (link_type&) m_header->left; }
-		link_type& rightmost() const { return (link_type&) m_header->right; }
+		link_type& root() const { return (link_type&) m_header->parent(); }
+		link_type& leftmost() const { return (link_type&) m_header->left(); }
+		link_type& rightmost() const { return (link_type&) m_header->right(); }
 
 	private:
 		void _initialize() {
@@ -117,18 +117,37 @@ namespace tools {
 		}
 
 		void _clear() {
-			// todo
+			if (!_trivial_teardown<value_type, _Allocator>::value) {
+				_erase_subtree(root());
+			}
+
+			root()      = nullptr;
+			leftmost()  = m_header;
+			rightmost() = m_header;
+			m_count     = 0;
+		}
+
+		/* recurse on the right, loop on the left */
+		void _erase_subtree(link_type p) {
+			while (nullptr != p) {
+				_erase_subtree(static_cast<link_type>(p->right()));
+				link_type left = static_cast<link_type>(p->left());
+				destroy_node(p);
+				p = left;
+			}
 		}
 
 	public:
-		explicit _avl_tree(const comparator_type& comp = _Comparator()) :
-			m_count(0), m_comp(comp) { _initialize(); }
+		explicit _avl_tree(const comparator_type& comp  = _Comparator(),
+		                   const _Allocator&      alloc = _Allocator()) :
+			allocator_type(alloc), m_count(0), m_comp(comp) { _initialize(); }
 
 		template <typename _InputIterator>
 		_avl_tree(_InputIterator         first,
 		          _InputIterator         last ,
-		          const comparator_type& comp = _Comparator()) :
-			m_count(0), m_comp(comp) {
+		          const comparator_type& comp  = _Comparator(),
+		          const _Allocator&      alloc = _Allocator()) :
+			allocator_type(alloc), m_count(0), m_comp(comp) {
 			_initialize();
 			while (first != last) {
 				this->insert_equal(*first);
@@ -151,6 +170,8 @@ namespace tools {
 
 
 	public:
+		_Allocator get_allocator() const { return allocator_type::get_allocator(); }
+
 		bool empty() const { return 0 == m_count; }
 		size_type size() const { return m_count; }
 		size_type max_size() const { return size_type(-1); }
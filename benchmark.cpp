@@ -0,0 +1,657 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ *
+ * usage: benchmark [name...], runs every benchmark when no name is given
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "algorithm.h"
+#include "bit_sequence.h"
+#include "double_list.h"
+#include "flat_hash_map.h"
+#include "flat_map.h"
+#include "functor.h"
+#include "huge_page_alloc.h"
+#include "mremap_alloc.h"
+#include "packed_int_sequence.h"
+#include "parallel.h"
+#include "rb_tree.h"
+#include "sequence.h"
+#include "sort.h"
+#include "thread_cache_alloc.h"
+
+namespace {
+
+	typedef std::chrono::steady_clock clock_type;
+
+	double seconds_since(clock_type::time_point start) {
+		return std::chrono::duration<double>(clock_type::now() - start).count();
+	}
+
+	unsigned max_threads() {
+		unsigned n = std::thread::hardware_concurrency();
+		return 0 == n ? 1 : n;
+	}
+
+	/* builds and tears down trees and lists, returns the number of node allocations */
+	template <typename _Allocator>
+	size_t node_churn(size_t rounds) {
+		typedef tools::_rb_tree<
+			int, int, tools::self<int>, tools::less<int>, _Allocator
+		> tree_type;
+		typedef tools::double_list<int, _Allocator> list_type;
+
+		size_t nodes = 0;
+		for (size_t r = 0; r < rounds; ++r) {
+			tree_type tree;
+			list_type list;
+			for (int i = 0; i < 1024; ++i) {
+				tree.insert_equal((i * 7919) & 1023);
+				list.push_back(i);
+			}
+			while (!list.empty()) {
+				list.pop_front();
+			}
+			nodes += 2 * 1024;
+		}
+		return nodes;
+	}
+
+	template <typename _Allocator>
+	void alloc_scaling_row(const char* name, unsigned threads) {
+		const size_t rounds = 200;
+
+		clock_type::time_point start = clock_type::now();
+		std::vector<std::thread> workers;
+		for (unsigned i = 0; i < threads; ++i) {
+			workers.emplace_back([rounds] { node_churn<_Allocator>(rounds); });
+		}
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+		double elapsed = seconds_since(start);
+
+		double total = double(threads) * rounds * 2 * 1024;
+		std::cout << "  " << name << " threads=" << threads
+		          << " Mnodes/s=" << total / elapsed / 1e6 << std::endl;
+	}
+
+	void alloc_scaling() {
+		std::cout << "alloc_scaling: _rb_tree + double_list node churn" << std::endl;
+		for (unsigned threads = 1; threads <= max_threads(); threads *= 2) {
+			alloc_scaling_row<std::allocator<int>>("std::allocator    ", threads);
+			alloc_scaling_row<tools::thread_cache_alloc>("thread_cache_alloc", threads);
+		}
+	}
+
+	/* dTLB load misses of this thread, -1 when perf events are unavailable */
+	class tlb_miss_counter {
+	private:
+		int m_fd;
+
+	public:
+		tlb_miss_counter() {
+			perf_event_attr attr;
+			memset(&attr, 0, sizeof (attr));
+			attr.size   = sizeof (attr);
+			attr.type   = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_DTLB |
+			              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			attr.disabled       = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv     = 1;
+			m_fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+		}
+
+		~tlb_miss_counter() {
+			if (0 <= m_fd) {
+				close(m_fd);
+			}
+		}
+
+		void start() {
+			if (0 <= m_fd) {
+				ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+
+		long long stop() {
+			long long count = -1;
+			if (0 <= m_fd) {
+				ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+				if (sizeof (count) != read(m_fd, &count, sizeof (count))) {
+					count = -1;
+				}
+			}
+			return count;
+		}
+	};
+
+	template <typename _Allocator>
+	void huge_page_row(const char* name, const _Allocator& alloc) {
+		const size_t length  = size_t(32) << 20; /* 256 MiB of uint64_t */
+		const size_t lookups = size_t(1) << 24;
+
+		tools::sequence<uint64_t, _Allocator> seq(length, alloc);
+		seq.resize(length);
+		for (size_t i = 0; i < length; ++i) {
+			seq[i] = i;
+		}
+
+		tlb_miss_counter counter;
+		uint64_t state = 88172645463325252ull;
+		uint64_t sum = 0;
+
+		clock_type::time_point start = clock_type::now();
+		counter.start();
+		for (size_t i = 0; i < lookups; ++i) {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			sum += seq[state & (length - 1)];
+		}
+		long long misses = counter.stop();
+		double elapsed = seconds_since(start);
+
+		std::cout << "  " << name
+		          << " ns/lookup=" << elapsed * 1e9 / lookups
+		          << " dTLB-misses=";
+		if (misses < 0) {
+			std::cout << "n/a";
+		}
+		else {
+			std::cout << misses;
+		}
+		std::cout << " (checksum " << sum << ")" << std::endl;
+	}
+
+	void huge_page() {
+		std::cout << "huge_page: random reads over a 256 MiB sequence<uint64_t>" << std::endl;
+		huge_page_row("std::allocator           ", std::allocator<uint64_t>());
+		huge_page_row("huge_page_alloc (THP)    ", tools::huge_page_alloc());
+		huge_page_row("huge_page_alloc (hugetlb)", tools::huge_page_alloc(
+			tools::huge_page_alloc::_huge_page_size, true
+		));
+	}
+
+	/* resets the peak resident set size, false when the kernel does not allow it */
+	bool reset_peak_rss() {
+		std::ofstream clear_refs("/proc/self/clear_refs");
+		clear_refs << "5";
+		clear_refs.flush();
+		return clear_refs.good();
+	}
+
+	/* peak resident set size in KiB, -1 if unknown */
+	long peak_rss_kb() {
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line)) {
+			if (0 == line.compare(0, 6, "VmHWM:")) {
+				return std::stol(line.substr(6));
+			}
+		}
+		return -1;
+	}
+
+	template <typename _Allocator>
+	void mremap_growth_row(const char* name, const _Allocator& alloc) {
+		const size_t length = size_t(32) << 20; /* 256 MiB of int64_t */
+
+		bool peak_known = reset_peak_rss();
+		clock_type::time_point start = clock_type::now();
+		{
+			tools::sequence<int64_t, _Allocator> seq(alloc);
+			for (size_t i = 0; i < length; ++i) {
+				seq.push_back(int64_t(i));
+			}
+		}
+		double elapsed = seconds_since(start);
+
+		std::cout << "  " << name
+		          << " ms=" << elapsed * 1e3
+		          << " peak-RSS-MiB=";
+		if (peak_known) {
+			std::cout << peak_rss_kb() / 1024;
+		}
+		else {
+			std::cout << "n/a";
+		}
+		std::cout << std::endl;
+	}
+
+	void mremap_growth() {
+		std::cout << "mremap_growth: push_back 256 MiB into sequence<int64_t>" << std::endl;
+		mremap_growth_row("std::allocator", std::allocator<int64_t>());
+		mremap_growth_row("mremap_alloc  ", tools::mremap_alloc());
+	}
+
+	template <typename _T>
+	void simd_scan_rows(const char* type_name) {
+		const size_t length = size_t(1) << 22;
+		const size_t rounds = 50;
+
+		tools::sequence<_T> seq(length);
+		for (size_t i = 0; i < length; ++i) {
+			seq.push_back(_T(int(i * 2654435761u % 1000)));
+		}
+
+		const char* names[] = { "scalar", "sse2  ", "avx2  " };
+		for (int level = tools::simd_scalar; level <= tools::detected_simd_level(); ++level) {
+			tools::set_simd_level(tools::simd_level(level));
+
+			double checksum = 0;
+			clock_type::time_point start = clock_type::now();
+			for (size_t r = 0; r < rounds; ++r) {
+				checksum += tools::find(seq, _T(1000)) - seq.begin();
+				checksum += tools::count(seq, _T(r));
+				checksum += tools::min_value(seq) + tools::max_value(seq);
+				checksum += tools::sum(seq);
+				checksum += tools::all_less(seq, _T(1000));
+			}
+			double elapsed = seconds_since(start);
+
+			std::cout << "  " << type_name << " " << names[level]
+			          << " GB/s=" << 6.0 * rounds * length * sizeof (_T) / elapsed / 1e9
+			          << " (checksum " << checksum << ")" << std::endl;
+		}
+		tools::set_simd_level(tools::detected_simd_level());
+	}
+
+	void simd_scan() {
+		std::cout << "simd_scan: find, count, min, max, sum, all_less over 4M elements" << std::endl;
+		simd_scan_rows<int32_t>("int32_t");
+		simd_scan_rows<float>("float  ");
+	}
+
+	template <typename _Function>
+	double parallel_row_seconds(_Function fn) {
+		clock_type::time_point start = clock_type::now();
+		fn();
+		return seconds_since(start);
+	}
+
+	void parallel_scaling_row(unsigned threads) {
+		const size_t length = size_t(1) << 23;
+
+		tools::fork_join_pool pool(threads);
+		tools::parallel::policy exec(16384, pool);
+
+		tools::sequence<uint32_t> input(length);
+		for (size_t i = 0; i < length; ++i) {
+			input.push_back(uint32_t(i * 2654435761u));
+		}
+		tools::sequence<uint64_t> output(length);
+		output.resize(length);
+		uint64_t checksum = 0;
+
+		double for_each_s = parallel_row_seconds([&] {
+			tools::parallel::for_each(exec, input.begin(), input.end(), [](uint32_t& x) {
+				x ^= x >> 7;
+			});
+		});
+		double transform_s = parallel_row_seconds([&] {
+			tools::parallel::transform(exec, input.begin(), input.end(), output.begin(), [](uint32_t x) {
+				return uint64_t(x) * x;
+			});
+		});
+		double reduce_s = parallel_row_seconds([&] {
+			checksum += tools::parallel::reduce(exec, output.begin(), output.end(),
+			                                    uint64_t(0), tools::plus<uint64_t>());
+		});
+		double scan_s = parallel_row_seconds([&] {
+			tools::parallel::inclusive_scan(exec, output.begin(), output.end(),
+			                                output.begin(), tools::plus<uint64_t>());
+		});
+		double partition_s = parallel_row_seconds([&] {
+			checksum += tools::parallel::partition(exec, input.begin(), input.end(), [](uint32_t x) {
+				return 0 == (x & 1);
+			}) - input.begin();
+		});
+		double sort_s = parallel_row_seconds([&] {
+			tools::parallel::sort(exec, input.begin(), input.end(), tools::less<uint32_t>());
+		});
+
+		double melems = length / 1e6;
+		std::cout << "  threads=" << threads
+		          << " Melem/s for_each=" << melems / for_each_s
+		          << " transform=" << melems / transform_s
+		          << " reduce=" << melems / reduce_s
+		          << " scan=" << melems / scan_s
+		          << " partition=" << melems / partition_s
+		          << " sort=" << melems / sort_s
+		          << " (checksum " << checksum + input[0] << ")" << std::endl;
+	}
+
+	void parallel_scaling() {
+		std::cout << "parallel_scaling: 8M elements per algorithm" << std::endl;
+		unsigned threads = 1;
+		for (; threads < max_threads(); threads *= 2) {
+			parallel_scaling_row(threads);
+		}
+		parallel_scaling_row(max_threads());
+	}
+
+	void bit_ops() {
+		const size_t bits   = size_t(1) << 26;
+		const size_t rounds = 20;
+		std::cout << "bit_ops: 64M flags, sequence<bool> against bit_sequence" << std::endl;
+
+		tools::sequence<bool> flags(bits);
+		tools::bit_sequence<> a, b;
+		for (size_t i = 0; i < bits; ++i) {
+			uint32_t x = uint32_t(i * 2654435761u);
+			flags.push_back(0 == (x & 3));
+			a.push_back(0 == (x & 3));
+			b.push_back(0 == (x & 5));
+		}
+		std::cout << "  bytes sequence<bool>=" << flags.capacity() * sizeof (bool)
+		          << " bit_sequence=" << a.word_count() * sizeof (uint64_t) << std::endl;
+
+		size_t checksum = 0;
+		clock_type::time_point start = clock_type::now();
+		for (size_t r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < bits; ++i) {
+				checksum += flags[i];
+			}
+		}
+		double bool_s = seconds_since(start);
+
+		const char* names[] = { "scalar", "sse2  ", "avx2  " };
+		std::cout << "  sequence<bool> count Gbit/s=" << 1.0 * rounds * bits / bool_s / 1e9 << std::endl;
+		for (int level = tools::simd_scalar; level <= tools::detected_simd_level(); ++level) {
+			tools::set_simd_level(tools::simd_level(level));
+
+			start = clock_type::now();
+			for (size_t r = 0; r < rounds; ++r) {
+				checksum += a.count();
+			}
+			double count_s = seconds_since(start);
+
+			start = clock_type::now();
+			for (size_t r = 0; r < rounds; ++r) {
+				tools::bit_sequence<> c(a);
+				c &= b;
+				c |= a;
+				c ^= b;
+				c.and_not(a);
+				checksum += c.find_first();
+			}
+			double ops_s = seconds_since(start);
+
+			std::cout << "  bit_sequence " << names[level]
+			          << " count Gbit/s=" << 1.0 * rounds * bits / count_s / 1e9
+			          << " copy+and/or/xor/andnot Gbit/s=" << 4.0 * rounds * bits / ops_s / 1e9
+			          << " (checksum " << checksum << ")" << std::endl;
+		}
+		tools::set_simd_level(tools::detected_simd_level());
+	}
+
+	void packed_ints() {
+		const size_t length = size_t(1) << 24;
+		std::cout << "packed_ints: 16M sorted ids with gaps below 64" << std::endl;
+
+		tools::sequence<uint64_t>   plain(length);
+		tools::packed_int_sequence<> packed;
+		uint64_t id = 0;
+		for (size_t i = 0; i < length; ++i) {
+			id += 1 + (uint32_t(i * 2654435761u) >> 26);
+			plain.push_back(id);
+			packed.push_back(id);
+		}
+		packed.shrink_to_fit();
+		std::cout << "  bytes sequence=" << plain.capacity() * sizeof (uint64_t)
+		          << " packed_int_sequence=" << packed.memory_usage() << std::endl;
+
+		uint64_t plain_checksum = 0;
+		clock_type::time_point start = clock_type::now();
+		for (uint64_t value : plain) {
+			plain_checksum += value;
+		}
+		double plain_scan_s = seconds_since(start);
+
+		start = clock_type::now();
+		for (size_t i = 0; i < length / 16; ++i) {
+			plain_checksum += std::lower_bound(plain.begin(), plain.end(), uint64_t(i * 2654435761u) % id) - plain.begin();
+		}
+		double plain_search_s = seconds_since(start);
+
+		std::cout << "  sequence scan Melem/s=" << length / plain_scan_s / 1e6
+		          << " lower_bound Mops/s=" << length / 16 / plain_search_s / 1e6
+		          << " (checksum " << plain_checksum << ")" << std::endl;
+
+		const char* names[] = { "scalar", "sse2  ", "avx2  " };
+		for (int level = tools::simd_scalar; level <= tools::detected_simd_level(); ++level) {
+			tools::set_simd_level(tools::simd_level(level));
+
+			uint64_t checksum = 0;
+			start = clock_type::now();
+			for (uint64_t value : packed) {
+				checksum += value;
+			}
+			double scan_s = seconds_since(start);
+
+			start = clock_type::now();
+			for (size_t i = 0; i < length / 16; ++i) {
+				checksum += packed.lower_bound(uint64_t(i * 2654435761u) % id);
+			}
+			double search_s = seconds_since(start);
+
+			std::cout << "  " << names[level]
+			          << " scan Melem/s=" << length / scan_s / 1e6
+			          << " lower_bound Mops/s=" << length / 16 / search_s / 1e6
+			          << " (checksum " << checksum << ")" << std::endl;
+		}
+		tools::set_simd_level(tools::detected_simd_level());
+	}
+
+	template <typename _T, typename _Sort>
+	double sort_row_seconds(const tools::sequence<_T>& input, _Sort sort) {
+		tools::sequence<_T> keys(input);
+		clock_type::time_point start = clock_type::now();
+		sort(keys.begin(), keys.end());
+		double elapsed = seconds_since(start);
+		if (!std::is_sorted(keys.begin(), keys.end())) {
+			std::cout << "  unsorted output" << std::endl;
+		}
+		return elapsed;
+	}
+
+	template <typename _T>
+	void sort_keys_rows(const char* pattern, const tools::sequence<_T>& input) {
+		typedef typename tools::sequence<_T>::iterator iterator;
+
+		double melems = input.size() / 1e6;
+		std::cout << "  " << pattern
+		          << " Melem/s std::sort=" << melems / sort_row_seconds(input, [](iterator first, iterator last) {
+		                 std::sort(first, last);
+		             })
+		          << " tools::sort=" << melems / sort_row_seconds(input, [](iterator first, iterator last) {
+		                 tools::sort(first, last);
+		             })
+		          << " radix_sort=" << melems / sort_row_seconds(input, [](iterator first, iterator last) {
+		                 tools::radix_sort(first, last);
+		             }) << std::endl;
+	}
+
+	void sort_keys() {
+		const size_t length = size_t(1) << 22;
+		std::cout << "sort_keys: 4M keys" << std::endl;
+
+		tools::sequence<uint32_t> random(length), sorted(length), reversed(length), few(length);
+		tools::sequence<float>    floats(length);
+		for (size_t i = 0; i < length; ++i) {
+			uint32_t x = uint32_t(i * 2654435761u) ^ uint32_t(i >> 7);
+			random.push_back(x);
+			sorted.push_back(uint32_t(i));
+			reversed.push_back(uint32_t(length - i));
+			few.push_back(x % 16);
+			floats.push_back(float(int32_t(x)) / 1024.0f);
+		}
+
+		sort_keys_rows("uint32 random  ", random);
+		sort_keys_rows("uint32 sorted  ", sorted);
+		sort_keys_rows("uint32 reversed", reversed);
+		sort_keys_rows("uint32 16 keys ", few);
+		sort_keys_rows("float random   ", floats);
+	}
+
+	void hash_lookup() {
+		const size_t length = size_t(1) << 20;
+		const size_t lookups = size_t(1) << 24;
+		std::cout << "hash_lookup: 1M uint64 keys, 16M finds, half of them misses" << std::endl;
+
+		typedef tools::_rb_tree<
+			uint64_t, uint64_t, tools::self<uint64_t>, tools::less<uint64_t>, std::allocator<uint64_t>
+		> tree_type;
+
+		tree_type                                tree;
+		std::unordered_map<uint64_t, uint64_t>   unordered;
+		tools::flat_hash_map<uint64_t, uint64_t> flat;
+		unordered.reserve(length);
+		flat.reserve(length);
+		for (uint64_t i = 0; i < length; ++i) {
+			uint64_t key = i * 0x9e3779b97f4a7c15ull;
+			tree.insert_unique(key);
+			unordered.emplace(key, i);
+			flat.emplace(key, i);
+		}
+
+		/* odd rounds look up keys that were never inserted */
+		size_t hits = 0;
+		clock_type::time_point start = clock_type::now();
+		for (uint64_t i = 0; i < lookups; ++i) {
+			hits += tree.end() != tree.find(((i * 40503) % length + (i & 1) * length) * 0x9e3779b97f4a7c15ull);
+		}
+		double tree_s = seconds_since(start);
+
+		start = clock_type::now();
+		for (uint64_t i = 0; i < lookups; ++i) {
+			hits += unordered.end() != unordered.find(((i * 40503) % length + (i & 1) * length) * 0x9e3779b97f4a7c15ull);
+		}
+		double unordered_s = seconds_since(start);
+
+		start = clock_type::now();
+		for (uint64_t i = 0; i < lookups; ++i) {
+			hits += flat.end() != flat.find(((i * 40503) % length + (i & 1) * length) * 0x9e3779b97f4a7c15ull);
+		}
+		double flat_s = seconds_since(start);
+
+		std::cout << "  Mfinds/s _rb_tree=" << lookups / tree_s / 1e6
+		          << " std::unordered_map=" << lookups / unordered_s / 1e6
+		          << " flat_hash_map=" << lookups / flat_s / 1e6
+		          << " (hits " << hits << ")" << std::endl;
+	}
+
+	void sorted_lookup() {
+		const size_t length = size_t(1) << 20;
+		const size_t lookups = size_t(1) << 22;
+		std::cout << "sorted_lookup: 1M uint64 keys, 4M lower_bound or find" << std::endl;
+
+		typedef tools::_rb_tree<
+			uint64_t, uint64_t, tools::self<uint64_t>, tools::less<uint64_t>, std::allocator<uint64_t>
+		> tree_type;
+
+		tools::sequence<uint64_t> keys(length);
+		for (uint64_t i = 0; i < length; ++i) {
+			keys.push_back(i * 0x9e3779b97f4a7c15ull);
+		}
+
+		tree_type tree;
+		clock_type::time_point start = clock_type::now();
+		for (uint64_t key : keys) {
+			tree.insert_unique(key);
+		}
+		double tree_build_s = seconds_since(start);
+
+		start = clock_type::now();
+		tools::flat_set<uint64_t> flat(keys.begin(), keys.end());
+		flat.shrink_to_fit();
+		double flat_build_s = seconds_since(start);
+
+		size_t hits = 0;
+		start = clock_type::now();
+		for (uint64_t i = 0; i < lookups; ++i) {
+			hits += tree.end() != tree.find(((i * 40503) % length + (i & 1) * length) * 0x9e3779b97f4a7c15ull);
+		}
+		double tree_s = seconds_since(start);
+
+		start = clock_type::now();
+		for (uint64_t i = 0; i < lookups; ++i) {
+			hits += flat.end() != flat.find(((i * 40503) % length + (i & 1) * length) * 0x9e3779b97f4a7c15ull);
+		}
+		double flat_s = seconds_since(start);
+
+		tools::sort(keys.begin(), keys.end());
+		start = clock_type::now();
+		for (uint64_t i = 0; i < lookups; ++i) {
+			hits += std::lower_bound(keys.begin(), keys.end(), uint64_t(i * 0x9e3779b97f4a7c15ull)) - keys.begin();
+		}
+		double std_s = seconds_since(start);
+
+		start = clock_type::now();
+		for (uint64_t i = 0; i < lookups; ++i) {
+			hits += flat.lower_bound(i * 0x9e3779b97f4a7c15ull) - flat.begin();
+		}
+		double flat_bound_s = seconds_since(start);
+
+		std::cout << "  bytes/elem _rb_tree=" << sizeof (tools::_rb_tree_node<uint64_t>)
+		          << " flat_set=" << 1.0 * flat.capacity() * sizeof (uint64_t) / flat.size() << std::endl
+		          << "  build Melem/s _rb_tree=" << length / tree_build_s / 1e6
+		          << " flat_set=" << length / flat_build_s / 1e6 << std::endl
+		          << "  find Mops/s _rb_tree=" << lookups / tree_s / 1e6
+		          << " flat_set=" << lookups / flat_s / 1e6 << std::endl
+		          << "  lower_bound Mops/s std::lower_bound=" << lookups / std_s / 1e6
+		          << " flat_set=" << lookups / flat_bound_s / 1e6
+		          << " (checksum " << hits << ")" << std::endl;
+	}
+
+	struct benchmark_entry {
+		const char* name;
+		void      (*run)();
+	};
+
+	const benchmark_entry benchmarks[] = {
+		{ "alloc_scaling",    alloc_scaling    },
+		{ "huge_page",        huge_page        },
+		{ "mremap_growth",    mremap_growth    },
+		{ "simd_scan",        simd_scan        },
+		{ "parallel_scaling", parallel_scaling },
+		{ "bit_ops",          bit_ops          },
+		{ "packed_ints",      packed_ints      },
+		{ "sort_keys",        sort_keys        },
+		{ "hash_lookup",      hash_lookup      },
+		{ "sorted_lookup",    sorted_lookup    },
+	};
+}
+
+int main(int argc, char* argv[]) {
+	for (const benchmark_entry& entry : benchmarks) {
+		bool selected = 1 == argc;
+		for (int i = 1; i < argc; ++i) {
+			selected = selected || 0 == strcmp(argv[i], entry.name);
+		}
+		if (selected) {
+			entry.run();
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,548 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _BIT_SEQUENCE_H_
+#define _BIT_SEQUENCE_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "algorithm.h"
+#include "sequence.h"
+
+namespace tools {
+
+	/*
+	 * Word kernels behind bit_sequence: dst op= src over n words, and
+	 * popcount over n words, picked like the scans in algorithm.h.
+	 */
+
+	struct _bits_and {
+		static uint64_t apply(uint64_t a, uint64_t b) { return a & b; }
+#ifdef _TOOLS_SIMD_X86
+		static __m128i apply(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+		__attribute__((target("avx2")))
+		static __m256i apply(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+#endif
+	};
+
+	struct _bits_or {
+		static uint64_t apply(uint64_t a, uint64_t b) { return a | b; }
+#ifdef _TOOLS_SIMD_X86
+		static __m128i apply(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+		__attribute__((target("avx2")))
+		static __m256i apply(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+#endif
+	};
+
+	struct _bits_xor {
+		static uint64_t apply(uint64_t a, uint64_t b) { return a ^ b; }
+#ifdef _TOOLS_SIMD_X86
+		static __m128i apply(__m128i a, __m128i b) { return _mm_xor_si128(a, b); }
+		__attribute__((target("avx2")))
+		static __m256i apply(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+#endif
+	};
+
+	struct _bits_and_not {
+		static uint64_t apply(uint64_t a, uint64_t b) { return a & ~b; }
+#ifdef _TOOLS_SIMD_X86
+		static __m128i apply(__m128i a, __m128i b) { return _mm_andnot_si128(b, a); }
+		__attribute__((target("avx2")))
+		static __m256i apply(__m256i a, __m256i b) { return _mm256_andnot_si256(b, a); }
+#endif
+	};
+
+	template <typename _Op>
+	inline void _combine_words_scalar(uint64_t* dst, const uint64_t* src, size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			dst[i] = _Op::apply(dst[i], src[i]);
+		}
+	}
+
+	inline size_t _count_words_scalar(const uint64_t* words, size_t n) {
+		size_t total = 0;
+		for (size_t i = 0; i < n; ++i) {
+			total += __builtin_popcountll(words[i]);
+		}
+		return total;
+	}
+
+#ifdef _TOOLS_SIMD_X86
+
+	template <typename _Op>
+	inline void _combine_words_sse2(uint64_t* dst, const uint64_t* src, size_t n) {
+		size_t i = 0;
+		for (; i + 2 <= n; i += 2) {
+			__m128i a = _mm_loadu_si128((const __m128i*) (dst + i));
+			__m128i b = _mm_loadu_si128((const __m128i*) (src + i));
+			_mm_storeu_si128((__m128i*) (dst + i), _Op::apply(a, b));
+		}
+		_combine_words_scalar<_Op>(dst + i, src + i, n - i);
+	}
+
+	template <typename _Op>
+	__attribute__((target("avx2")))
+	inline void _combine_words_avx2(uint64_t* dst, const uint64_t* src, size_t n) {
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m256i a = _mm256_loadu_si256((const __m256i*) (dst + i));
+			__m256i b = _mm256_loadu_si256((const __m256i*) (src + i));
+			_mm256_storeu_si256((__m256i*) (dst + i), _Op::apply(a, b));
+		}
+		_combine_words_scalar<_Op>(dst + i, src + i, n - i);
+	}
+
+	/* every cpu with avx2 has popcnt, the baseline may not */
+	__attribute__((target("popcnt")))
+	inline size_t _count_words_popcnt(const uint64_t* words, size_t n) {
+		size_t total = 0;
+		for (size_t i = 0; i < n; ++i) {
+			total += __builtin_popcountll(words[i]);
+		}
+		return total;
+	}
+
+	template <typename _Op>
+	inline void _combine_words(uint64_t* dst, const uint64_t* src, size_t n) {
+		switch (active_simd_level()) {
+			case simd_avx2: _combine_words_avx2<_Op>(dst, src, n); break;
+			case simd_sse2: _combine_words_sse2<_Op>(dst, src, n); break;
+			default:        _combine_words_scalar<_Op>(dst, src, n); break;
+		}
+	}
+
+	inline size_t _count_words(const uint64_t* words, size_t n) {
+		return simd_avx2 == active_simd_level() ?
+			_count_words_popcnt(words, n) : _count_words_scalar(words, n);
+	}
+
+#else
+
+	template <typename _Op>
+	inline void _combine_words(uint64_t* dst, const uint64_t* src, size_t n) {
+		_combine_words_scalar<_Op>(dst, src, n);
+	}
+
+	inline size_t _count_words(const uint64_t* words, size_t n) {
+		return _count_words_scalar(words, n);
+	}
+
+#endif //_TOOLS_SIMD_X86
+
+	/*
+	 * Bits packed 64 to a word in a sequence. Elements are reached through
+	 * proxy references; whole-range queries and the set operations work a
+	 * word at a time. Bits past size() in the last word are kept clear, so
+	 * no kernel has to mask them.
+	 *
+	 * insert/erase/contains treat it as a dense set of ids, growing to fit
+	 * the largest id inserted.
+	 */
+	template <
+		typename _Allocator = std::allocator<uint64_t>,
+		typename _Growth    = growth::doubling
+	>
+	class bit_sequence {
+	public:
+		typedef bool      value_type;
+		typedef bool      const_reference;
+		typedef uint64_t  word_type;
+		typedef ptrdiff_t difference_type;
+		typedef size_t    size_type;
+
+		static constexpr size_type npos = size_type(-1);
+
+	protected:
+		typedef bit_sequence<_Allocator, _Growth>            self_type;
+		typedef sequence<word_type, _Allocator, _Growth>     word_sequence;
+
+		enum { _word_bits = 64 };
+
+		static size_type _words_for(size_type bits) { return (bits + _word_bits - 1) / _word_bits; }
+		static word_type _bit(size_type index) { return word_type(1) << (index % _word_bits); }
+
+	public:
+		class reference {
+		private:
+			word_type* m_word;
+			word_type  m_mask;
+
+		public:
+			reference(word_type* word, word_type mask) : m_word(word), m_mask(mask) { }
+
+		public:
+			operator bool() const { return 0 != (*m_word & m_mask); }
+			bool operator~() const { return 0 == (*m_word & m_mask); }
+
+			reference& operator=(bool val) {
+				if (val) {
+					*m_word |= m_mask;
+				}
+				else {
+					*m_word &= ~m_mask;
+				}
+				return *this;
+			}
+
+			reference& operator=(const reference& other) { return operator=(bool(other)); }
+
+			void flip() { *m_word ^= m_mask; }
+
+			/* swaps the bits, not the proxies */
+			friend void swap(reference left, reference right) {
+				bool tmp = left;
+				left  = bool(right);
+				right = tmp;
+			}
+		};
+
+		template <bool _Const>
+		class _bit_iterator {
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef bool                            value_type;
+			typedef ptrdiff_t                       difference_type;
+			typedef void                            pointer;
+			typedef typename std::conditional<_Const, bool, typename bit_sequence::reference>::type reference;
+			typedef typename std::conditional<_Const, const word_type*, word_type*>::type          word_pointer;
+
+		private:
+			word_pointer m_words;
+			size_type    m_index;
+
+			bool _get(_true_type) const { return 0 != (m_words[m_index / _word_bits] & _bit(m_index)); }
+			reference _get(_false_type) const { return reference(m_words + m_index / _word_bits, _bit(m_index)); }
+
+		public:
+			_bit_iterator() : m_words(nullptr), m_index(0) { }
+			_bit_iterator(word_pointer words, size_type index) : m_words(words), m_index(index) { }
+
+			/* iterator to const_iterator */
+			template <bool _Other, typename = typename std::enable_if<_Const && !_Other>::type>
+			_bit_iterator(const _bit_iterator<_Other>& other) : m_words(other.words()), m_index(other.index()) { }
+
+		public:
+			word_pointer words() const { return m_words; }
+			size_type index() const { return m_index; }
+
+			reference operator*() const { return _get(_bool_type<_Const>()); }
+			reference operator[](difference_type n) const { return *(*this + n); }
+
+			_bit_iterator& operator++() { ++m_index; return *this; }
+			_bit_iterator operator++(int) { _bit_iterator tmp = *this; ++m_index; return tmp; }
+
+			_bit_iterator& operator--() { --m_index; return *this; }
+			_bit_iterator operator--(int) { _bit_iterator tmp = *this; --m_index; return tmp; }
+
+			_bit_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+			_bit_iterator operator+(difference_type n) const { _bit_iterator tmp = *this; return tmp += n; }
+
+			_bit_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+			_bit_iterator operator-(difference_type n) const { _bit_iterator tmp = *this; return tmp -= n; }
+
+			difference_type operator-(const _bit_iterator& other) const {
+				return difference_type(m_index) - difference_type(other.m_index);
+			}
+
+			bool operator==(const _bit_iterator& other) const { return m_index == other.m_index; }
+			bool operator!=(const _bit_iterator& other) const { return m_index != other.m_index; }
+			bool operator<(const _bit_iterator& other) const { return m_index < other.m_index; }
+			bool operator>(const _bit_iterator& other) const { return m_index > other.m_index; }
+			bool operator<=(const _bit_iterator& other) const { return m_index <= other.m_index; }
+			bool operator>=(const _bit_iterator& other) const { return m_index >= other.m_index; }
+		};
+
+		typedef _bit_iterator<false> iterator;
+		typedef _bit_iterator<true>  const_iterator;
+
+	private:
+		word_sequence m_words;
+		size_type     m_size;
+
+	protected:
+		/* clears the bits past m_size in the last word */
+		void _trim() {
+			if (0 != m_size % _word_bits) {
+				m_words.back() &= (word_type(1) << (m_size % _word_bits)) - 1;
+			}
+		}
+
+		template <typename _Op>
+		void _combine(const self_type& other) {
+			size_type n = std::min(m_words.size(), other.m_words.size());
+			if (0 != n) {
+				_combine_words<_Op>(&m_words[0], &other.m_words[0], n);
+			}
+		}
+
+	public:
+		bit_sequence() : m_size(0) { }
+		explicit bit_sequence(const _Allocator& alloc) : m_words(alloc), m_size(0) { }
+
+		explicit bit_sequence(size_type n, bool val = false, const _Allocator& alloc = _Allocator()) :
+			m_words(alloc), m_size(0) {
+			resize(n, val);
+		}
+
+		bit_sequence(const self_type&) = default;
+
+		bit_sequence(self_type&& other) noexcept :
+			m_words(std::move(other.m_words)), m_size(other.m_size) {
+			other.m_size = 0;
+		}
+
+		self_type& operator=(const self_type& other) {
+			if (this != &other) {
+				self_type tmp(other);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		self_type& operator=(self_type&& other) noexcept {
+			if (this != &other) {
+				self_type tmp(std::move(other));
+				swap(tmp);
+			}
+			return *this;
+		}
+
+	public:
+		bool test(size_type index) const {
+			assert(index < m_size);
+			return 0 != (m_words[index / _word_bits] & _bit(index));
+		}
+
+		const_reference operator[](size_type index) const { return test(index); }
+
+		reference operator[](size_type index) {
+			assert(index < m_size);
+			return reference(&m_words[index / _word_bits], _bit(index));
+		}
+
+		const_reference at(size_type index) const {
+			if (m_size <= index) {
+				throw std::out_of_range("bit_sequence index out of range");
+			}
+			return test(index);
+		}
+
+		reference at(size_type index) {
+			if (m_size <= index) {
+				throw std::out_of_range("bit_sequence index out of range");
+			}
+			return operator[](index);
+		}
+
+		void set(size_type index, bool val = true) { operator[](index) = val; }
+		void reset(size_type index) { operator[](index) = false; }
+		void flip(size_type index) { operator[](index).flip(); }
+
+		void set() {
+			std::fill(m_words.begin(), m_words.end(), ~word_type(0));
+			_trim();
+		}
+
+		void reset() { std::fill(m_words.begin(), m_words.end(), word_type(0)); }
+
+		void flip() {
+			for (size_type i = 0; i < m_words.size(); ++i) {
+				m_words[i] = ~m_words[i];
+			}
+			_trim();
+		}
+
+		const_reference front() const { return test(0); }
+		reference front() { return operator[](0); }
+
+		const_reference back() const { return test(m_size - 1); }
+		reference back() { return operator[](m_size - 1); }
+
+	public:
+		size_type count() const { return m_words.empty() ? 0 : _count_words(&m_words[0], m_words.size()); }
+
+		bool any() const {
+			return m_words.end() != std::find_if(m_words.begin(), m_words.end(),
+			                                     [](word_type w) { return 0 != w; });
+		}
+
+		bool none() const { return !any(); }
+		bool all() const { return count() == m_size; }
+
+		/* index of the first set bit, npos when none */
+		size_type find_first() const { return _find_from(0); }
+
+		/* index of the first set bit after index, npos when none */
+		size_type find_next(size_type index) const {
+			return npos == index || m_size <= index + 1 ? npos : _find_from(index + 1);
+		}
+
+	private:
+		size_type _find_from(size_type index) const {
+			size_type w = index / _word_bits;
+			if (m_words.size() <= w) {
+				return npos;
+			}
+
+			word_type word = m_words[w] & (~word_type(0) << (index % _word_bits));
+			while (0 == word) {
+				if (m_words.size() == ++w) {
+					return npos;
+				}
+				word = m_words[w];
+			}
+			return w * _word_bits + __builtin_ctzll(word);
+		}
+
+	public:
+		/* bits past the shorter operand count as clear; |= and ^= grow to the longer one */
+
+		self_type& operator&=(const self_type& other) {
+			_combine<_bits_and>(other);
+			if (other.m_words.size() < m_words.size()) {
+				std::fill(m_words.begin() + other.m_words.size(), m_words.end(), word_type(0));
+			}
+			return *this;
+		}
+
+		self_type& operator|=(const self_type& other) {
+			if (m_size < other.m_size) {
+				resize(other.m_size);
+			}
+			_combine<_bits_or>(other);
+			return *this;
+		}
+
+		self_type& operator^=(const self_type& other) {
+			if (m_size < other.m_size) {
+				resize(other.m_size);
+			}
+			_combine<_bits_xor>(other);
+			return *this;
+		}
+
+		/* clears every bit set in other */
+		self_type& and_not(const self_type& other) {
+			_combine<_bits_and_not>(other);
+			return *this;
+		}
+
+		self_type& operator-=(const self_type& other) { return and_not(other); }
+
+	public:
+		/* dense id set: true when id was not there yet */
+		bool insert(size_type id) {
+			if (m_size <= id) {
+				resize(id + 1);
+			}
+			reference bit = operator[](id);
+			if (bit) {
+				return false;
+			}
+			bit = true;
+			return true;
+		}
+
+		/* true when id was there */
+		bool erase(size_type id) {
+			if (m_size <= id || !test(id)) {
+				return false;
+			}
+			reset(id);
+			return true;
+		}
+
+		bool contains(size_type id) const { return id < m_size && test(id); }
+
+	public:
+		_Allocator get_allocator() const { return m_words.get_allocator(); }
+
+		bool empty() const { return 0 == m_size; }
+		size_type size() const { return m_size; }
+		size_type max_size() const { return size_type(-1) - _word_bits; }
+		size_type capacity() const { return m_words.capacity() * _word_bits; }
+
+		size_type word_count() const { return m_words.size(); }
+		const word_type* data() const { return m_words.empty() ? nullptr : &m_words[0]; }
+		word_type* data() { return m_words.empty() ? nullptr : &m_words[0]; }
+
+		void reserve(size_type bits) { m_words.reserve(_words_for(bits)); }
+		void shrink_to_fit() { m_words.shrink_to_fit(); }
+
+		void clear() {
+			m_words.clear();
+			m_size = 0;
+		}
+
+		void resize(size_type n, bool val = false) {
+			size_type old_size = m_size;
+			m_words.resize(_words_for(n));
+			m_size = n;
+			if (old_size < n && val) {
+				size_type w = old_size / _word_bits;
+				if (0 != old_size % _word_bits) {
+					m_words[w++] |= ~word_type(0) << (old_size % _word_bits);
+				}
+				std::fill(m_words.begin() + w, m_words.end(), ~word_type(0));
+			}
+			_trim();
+		}
+
+		void push_back(bool val) {
+			if (0 == m_size % _word_bits) {
+				m_words.push_back(word_type(0));
+			}
+			++m_size;
+			if (val) {
+				m_words.back() |= _bit(m_size - 1);
+			}
+		}
+
+		void pop_back() {
+			assert(!empty());
+			--m_size;
+			if (0 == m_size % _word_bits) {
+				m_words.pop_back();
+			}
+			else {
+				_trim();
+			}
+		}
+
+		iterator begin() { return iterator(data(), 0); }
+		const_iterator begin() const { return const_iterator(data(), 0); }
+
+		iterator end() { return iterator(data(), m_size); }
+		const_iterator end() const { return const_iterator(data(), m_size); }
+
+		void swap(self_type& other) {
+			m_words.swap(other.m_words);
+			std::swap(m_size, other.m_size);
+		}
+
+		bool operator==(const self_type& other) const {
+			return m_size == other.m_size && std::equal(m_words.begin(), m_words.end(), other.m_words.begin());
+		}
+
+		bool operator!=(const self_type& other) const { return !operator==(other); }
+	};
+
+	template <typename _Allocator, typename _Growth>
+	constexpr typename bit_sequence<_Allocator, _Growth>::size_type bit_sequence<_Allocator, _Growth>::npos;
+
+	template <typename _Allocator, typename _Growth>
+	inline void swap(bit_sequence<_Allocator, _Growth>& left,
+	                 bit_sequence<_Allocator, _Growth>& right) {
+		left.swap(right);
+	}
+}
+
+#endif //_BIT_SEQUENCE_H_
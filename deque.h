@@ -0,0 +1,428 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _DEQUE_H_
+#define _DEQUE_H_
+
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "iterator.h"
+#include "memory.h"
+
+namespace tools {
+
+	/*
+	 * Double ended queue on a ring buffer whose capacity is a power of
+	 * two, so positions wrap with a mask. Both ends push and pop in O(1);
+	 * the buffer doubles when full and the elements are unwrapped into
+	 * the new one. push_n and pop_n move a batch in at most two
+	 * contiguous segments, plain memcpy for trivially copyable types.
+	 */
+	template <
+		typename _Val,
+		typename _Allocator = std::allocator<_Val>
+	>
+	class deque : private standard_alloc<_Val, _Allocator> {
+	public:
+		typedef _Val        value_type;
+		typedef _Val&       reference;
+		typedef const _Val& const_reference;
+		typedef _Val*       pointer;
+		typedef const _Val* const_pointer;
+
+		typedef ptrdiff_t difference_type;
+		typedef size_t    size_type;
+
+	protected:
+		typedef deque<_Val, _Allocator>       self_type;
+		typedef standard_alloc<_Val, _Allocator> allocator_type;
+
+	public:
+		/* position head + i, masked on access, so it needs no wrap checks */
+		template <typename _Pointer, typename _Reference>
+		class _ring_iterator {
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef _Val                            value_type;
+			typedef _Reference                      reference;
+			typedef _Pointer                        pointer;
+			typedef ptrdiff_t                       difference_type;
+
+		private:
+			_Val*     m_buffer;
+			size_type m_mask;
+			size_type m_index;
+
+		public:
+			_ring_iterator() : m_buffer(nullptr), m_mask(0), m_index(0) { }
+			_ring_iterator(_Val* buffer, size_type mask, size_type index) :
+				m_buffer(buffer), m_mask(mask), m_index(index) { }
+
+			template <typename _OtherPointer, typename _OtherReference>
+			_ring_iterator(const _ring_iterator<_OtherPointer, _OtherReference>& other) :
+				m_buffer(other.buffer()), m_mask(other.mask()), m_index(other.index()) { }
+
+		public:
+			_Val* buffer() const { return m_buffer; }
+			size_type mask() const { return m_mask; }
+			size_type index() const { return m_index; }
+
+			reference operator*() const { return m_buffer[m_index & m_mask]; }
+			pointer operator->() const { return &operator*(); }
+			reference operator[](difference_type n) const { return m_buffer[(m_index + n) & m_mask]; }
+
+			_ring_iterator& operator++() { ++m_index; return *this; }
+			_ring_iterator operator++(int) { _ring_iterator tmp = *this; ++m_index; return tmp; }
+
+			_ring_iterator& operator--() { --m_index; return *this; }
+			_ring_iterator operator--(int) { _ring_iterator tmp = *this; --m_index; return tmp; }
+
+			_ring_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+			_ring_iterator operator+(difference_type n) const {
+				return _ring_iterator(m_buffer, m_mask, m_index + n);
+			}
+
+			_ring_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+			_ring_iterator operator-(difference_type n) const {
+				return _ring_iterator(m_buffer, m_mask, m_index - n);
+			}
+
+			template <typename _P, typename _R>
+			difference_type operator-(const _ring_iterator<_P, _R>& other) const {
+				return difference_type(m_index - other.index());
+			}
+
+			template <typename _P, typename _R>
+			bool operator==(const _ring_iterator<_P, _R>& other) const { return m_index == other.index(); }
+
+			template <typename _P, typename _R>
+			bool operator!=(const _ring_iterator<_P, _R>& other) const { return m_index != other.index(); }
+
+			template <typename _P, typename _R>
+			bool operator<(const _ring_iterator<_P, _R>& other) const { return *this - other < 0; }
+
+			template <typename _P, typename _R>
+			bool operator>(const _ring_iterator<_P, _R>& other) const { return *this - other > 0; }
+
+			template <typename _P, typename _R>
+			bool operator<=(const _ring_iterator<_P, _R>& other) const { return !(*this > other); }
+
+			template <typename _P, typename _R>
+			bool operator>=(const _ring_iterator<_P, _R>& other) const { return !(*this < other); }
+		};
+
+		typedef _ring_iterator<pointer, reference>             iterator;
+		typedef _ring_iterator<const_pointer, const_reference> const_iterator;
+
+		typedef _reverse_iterator<iterator>       reverse_iterator;
+		typedef _reverse_iterator<const_iterator> const_reverse_iterator;
+
+	private:
+		pointer   m_buffer;
+		size_type m_capacity; /* zero or a power of two */
+		size_type m_head;
+		size_type m_size;
+
+	private:
+		size_type _mask() const { return 0 == m_capacity ? 0 : m_capacity - 1; }
+		size_type _slot(size_type i) const { return (m_head + i) & _mask(); }
+
+		static size_type _round_up(size_type n) {
+			size_type capacity = 1;
+			while (capacity < n) {
+				capacity *= 2;
+			}
+			return capacity;
+		}
+
+		pointer _allocate(size_type n) {
+			pointer p = allocator_type::allocate(n);
+			if (nullptr == p && 0 != n) {
+				throw std::bad_alloc();
+			}
+			return p;
+		}
+
+		/* [first, first + n) of the ring as at most two contiguous pieces */
+		void _segments(size_type first, size_type n,
+		               pointer& a, size_type& a_len, pointer& b, size_type& b_len) const {
+			size_type start = _slot(first);
+			a     = m_buffer + start;
+			a_len = n < m_capacity - start ? n : m_capacity - start;
+			b     = m_buffer;
+			b_len = n - a_len;
+		}
+
+		/* unwraps the elements into a buffer of new_capacity, the old one stays intact on failure */
+		void _extend(size_type new_capacity) {
+			pointer new_buffer = _allocate(new_capacity);
+
+			pointer a, b;
+			size_type a_len, b_len;
+			_segments(0, m_size, a, a_len, b, b_len);
+
+			pointer p = new_buffer;
+			try {
+				p = tools::uninitialized_move_if_noexcept(a, a + a_len, p);
+				tools::uninitialized_move_if_noexcept(b, b + b_len, p);
+			}
+			catch (...) {
+				destroy(new_buffer, p);
+				allocator_type::deallocate(new_buffer, new_capacity);
+				throw;
+			}
+
+			destroy(a, a + a_len);
+			destroy(b, b + b_len);
+			allocator_type::deallocate(m_buffer, m_capacity);
+
+			m_buffer   = new_buffer;
+			m_capacity = new_capacity;
+			m_head     = 0;
+		}
+
+		void _grow_for(size_type extra) {
+			if (m_capacity - m_size < extra) {
+				_extend(_round_up(m_size + extra));
+			}
+		}
+
+		/* moves n elements out to initialised storage at result */
+		static pointer _move_out(pointer first, size_type n, pointer result, _true_type) {
+			if (0 != n) {
+				memcpy(result, first, n * sizeof (_Val));
+			}
+			return result + n;
+		}
+
+		static pointer _move_out(pointer first, size_type n, pointer result, _false_type) {
+			for (size_type i = 0; i < n; ++i) {
+				*result++ = std::move(first[i]);
+			}
+			destroy(first, first + n);
+			return result;
+		}
+
+		void _swap(self_type& other) {
+			std::swap((allocator_type&) *this, (allocator_type&) other);
+			std::swap(m_buffer, other.m_buffer);
+			std::swap(m_capacity, other.m_capacity);
+			std::swap(m_head, other.m_head);
+			std::swap(m_size, other.m_size);
+		}
+
+	public:
+		deque() : m_buffer(nullptr), m_capacity(0), m_head(0), m_size(0) { }
+
+		explicit deque(const _Allocator& alloc) :
+			allocator_type(alloc), m_buffer(nullptr), m_capacity(0), m_head(0), m_size(0) { }
+
+		deque(const self_type& other) :
+			allocator_type(other), m_buffer(nullptr), m_capacity(0), m_head(0), m_size(0) {
+			reserve(other.m_size);
+			for (const_iterator it = other.begin(); it != other.end(); ++it) {
+				push_back(*it);
+			}
+		}
+
+		deque(self_type&& other) noexcept :
+			allocator_type(std::move((allocator_type&) other)),
+			m_buffer(other.m_buffer), m_capacity(other.m_capacity),
+			m_head(other.m_head), m_size(other.m_size) {
+			other.m_buffer   = nullptr;
+			other.m_capacity = 0;
+			other.m_head     = 0;
+			other.m_size     = 0;
+		}
+
+		template <typename _InputIterator>
+		deque(_InputIterator    first,
+		      _InputIterator    last ,
+		      const _Allocator& alloc = _Allocator()) :
+			allocator_type(alloc), m_buffer(nullptr), m_capacity(0), m_head(0), m_size(0) {
+			while (first != last) {
+				push_back(*first);
+				++first;
+			}
+		}
+
+		~deque() {
+			clear();
+			allocator_type::deallocate(m_buffer, m_capacity);
+		}
+
+	public:
+		self_type& operator=(const self_type& other) {
+			if (this != &other) {
+				self_type tmp(other);
+				_swap(tmp);
+			}
+			return *this;
+		}
+
+		self_type& operator=(self_type&& other) noexcept {
+			if (this != &other) {
+				self_type tmp(std::move(other));
+				_swap(tmp);
+			}
+			return *this;
+		}
+
+		const_reference operator[](size_type index) const {
+			assert(index < m_size);
+			return m_buffer[_slot(index)];
+		}
+
+		reference operator[](size_type index) {
+			return const_cast<reference>(
+				((const self_type*) this)->operator[](index)
+			);
+		}
+
+	public:
+		_Allocator get_allocator() const { return allocator_type::get_allocator(); }
+
+		bool empty() const { return 0 == m_size; }
+		size_type size() const { return m_size; }
+		size_type max_size() const { return size_type(-1); }
+		size_type capacity() const { return m_capacity; }
+
+		reference at(size_type index) { return operator[](index); }
+		const_reference at(size_type index) const { return operator[](index); }
+
+		reference front() { return const_cast<reference>(((const self_type*) this)->front()); }
+		const_reference front() const { assert(!empty()); return m_buffer[m_head]; }
+
+		reference back() { return const_cast<reference>(((const self_type*) this)->back()); }
+		const_reference back() const { assert(!empty()); return m_buffer[_slot(m_size - 1)]; }
+
+		void clear() {
+			pointer a, b;
+			size_type a_len, b_len;
+			_segments(0, m_size, a, a_len, b, b_len);
+			destroy(a, a + a_len);
+			destroy(b, b + b_len);
+			m_head = 0;
+			m_size = 0;
+		}
+
+		void reserve(size_type new_capacity) {
+			if (m_capacity < new_capacity) {
+				_extend(_round_up(new_capacity));
+			}
+		}
+
+		template <typename... _Args>
+		void emplace_back(_Args&&... args) {
+			if (m_size == m_capacity) {
+				/* args may refer to an element about to move */
+				value_type tmp(std::forward<_Args>(args)...);
+				_extend(0 == m_capacity ? 1 : m_capacity * 2);
+				construct(m_buffer + _slot(m_size), std::move(tmp));
+			}
+			else {
+				construct(m_buffer + _slot(m_size), std::forward<_Args>(args)...);
+			}
+			++m_size;
+		}
+
+		template <typename... _Args>
+		void emplace_front(_Args&&... args) {
+			if (m_size == m_capacity) {
+				value_type tmp(std::forward<_Args>(args)...);
+				_extend(0 == m_capacity ? 1 : m_capacity * 2);
+				construct(m_buffer + _mask(), std::move(tmp));
+				m_head = _mask();
+			}
+			else {
+				size_type head = (m_head - 1) & _mask();
+				construct(m_buffer + head, std::forward<_Args>(args)...);
+				m_head = head;
+			}
+			++m_size;
+		}
+
+		void push_back(const value_type& val) { emplace_back(val); }
+		void push_back(value_type&& val) { emplace_back(std::move(val)); }
+
+		void push_front(const value_type& val) { emplace_front(val); }
+		void push_front(value_type&& val) { emplace_front(std::move(val)); }
+
+		void pop_back() {
+			assert(!empty());
+			--m_size;
+			destroy(m_buffer + _slot(m_size));
+		}
+
+		void pop_front() {
+			assert(!empty());
+			destroy(m_buffer + m_head);
+			m_head = (m_head + 1) & _mask();
+			--m_size;
+		}
+
+		/* appends [src, src + n), growing at most once */
+		void push_n(const value_type* src, size_type n) {
+			_grow_for(n);
+
+			pointer a, b;
+			size_type a_len, b_len;
+			_segments(m_size, n, a, a_len, b, b_len);
+
+			tools::uninitialized_copy(src, src + a_len, a);
+			try {
+				tools::uninitialized_copy(src + a_len, src + n, b);
+			}
+			catch (...) {
+				destroy(a, a + a_len);
+				throw;
+			}
+			m_size += n;
+		}
+
+		/* moves up to n elements from the front into dst, returns how many */
+		size_type pop_n(value_type* dst, size_type n) {
+			if (m_size < n) {
+				n = m_size;
+			}
+
+			pointer a, b;
+			size_type a_len, b_len;
+			_segments(0, n, a, a_len, b, b_len);
+
+			dst = _move_out(a, a_len, dst, _is_trivially_copyable<_Val>());
+			_move_out(b, b_len, dst, _is_trivially_copyable<_Val>());
+
+			m_head = (m_head + n) & _mask();
+			m_size -= n;
+			return n;
+		}
+
+		iterator begin() { return iterator(m_buffer, _mask(), m_head); }
+		const_iterator begin() const { return const_iterator(m_buffer, _mask(), m_head); }
+
+		iterator end() { return iterator(m_buffer, _mask(), m_head + m_size); }
+		const_iterator end() const { return const_iterator(m_buffer, _mask(), m_head + m_size); }
+
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+		void swap(self_type& other) { _swap(other); }
+	};
+
+	template <typename _Val, typename _Allocator>
+	inline void swap(deque<_Val, _Allocator>& left, deque<_Val, _Allocator>& right) {
+		left.swap(right);
+	}
+}
+
+#endif //_DEQUE_H_
@@ -5,6 +5,8 @@
 #ifndef _DOUBLE_LIST_H_
 #define _DOUBLE_LIST_H_
 
+#include <stdexcept>
+
 #include "iterator.h"
 #include "memory.h"
 
@@ -33,7 +35,7 @@ namespace tools {
         typedef _Val                value_type;
 
         explicit dlist_node(const value_type& value) :
-                val(value) , dlist_node_base() {}
+                dlist_node_base(), val(value) {}
 
         value_type  val;
     };
@@ -72,10 +74,10 @@ namespace tools {
     public:
         dlist_const_iterator() = default;
         dlist_const_iterator(const self_type&) = default;
-        dlist_const_iterator(const base_type& other) : base_ptr (other.node){}
+        dlist_const_iterator(const base_type& other) : base_type(other.node){}
         explicit dlist_const_iterator(link_type p) : base_type(p){}
 
-        reference operator*() const {return link_type(node);}
+        reference operator*() const {return link_type(node)->val;}
         pointer operator->() const {return &(operator*());}
 
         self_type& operator++() {
@@ -106,11 +108,11 @@ namespace tools {
     struct dlist_iterator : dlist_base_iterator {
     public:
         typedef _Val        value_type;
-        typedef const _Val& reference;
-        typedef const _Val* pointer;
+        typedef _Val&       reference;
+        typedef _Val*       pointer;
 
     protected:
-        typedef dlist_const_iterator<_Val>              self_type;
+        typedef dlist_iterator<_Val>                    self_type;
         typedef dlist_base_iterator                     base_type;
         typedef typename dlist_node<_Val>::link_type    link_type;
 
@@ -120,7 +122,7 @@ namespace tools {
         explicit dlist_iterator(link_type p) : base_type(p) {}
 
         reference operator*() const {
-            return link_type (node);
+            return link_type (node)->val;
         }
 
         pointer operator->() const {
@@ -158,7 +160,7 @@ namespace tools {
     template <typename _Val,
             typename _Allocator = std::allocator<dlist_node<_Val>>
     >
-    class double_list {
+    class double_list : private standard_alloc<dlist_node<_Val>, _Allocator> {
     public:
         typedef _Val        value_type;
         typedef _Val*       pointer;
@@ -224,8 +226,13 @@ namespace tools {
         }
 
         void _clear() {
-            while (!empty()) {
-                _erase_after(m_head);
+            if (_trivial_teardown<value_type, _Allocator>::value) {
+                head() = m_head;
+            }
+            else {
+                while (!empty()) {
+                    _erase_after(m_head);
+                }
             }
             tail() = m_head;
         }
@@ -253,8 +260,13 @@ namespace tools {
             _initialize();
         }
 
+        explicit double_list(const _Allocator& alloc) : allocator_type(alloc) {
+            _initialize();
+        }
+
         template <typename _InputIterator>
-        double_list(_InputIterator first,_InputIterator last) {
+        double_list(_InputIterator first,_InputIterator last,
+                    const _Allocator& alloc = _Allocator()) : allocator_type(alloc) {
             _initialize();
             while (first != last) {
                 this->push_back(*first);
@@ -262,6 +274,33 @@ namespace tools {
             }
         }
 
+        double_list(const self_type& other) : allocator_type(other) {
+            _initialize();
+            try {
+                for (const_iterator it = other.begin(); it != other.end(); ++it) {
+                    this->push_back(*it);
+                }
+            }
+            catch (...) {
+                _clear();
+                put_node(m_head);
+                throw;
+            }
+        }
+
+        self_type& operator=(const self_type& other) {
+            if (this != &other) {
+                self_type tmp(other);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~double_list() {
+            _clear();
+            put_node(m_head);
+        }
+
     protected:
         typedef dlist_iterator<value_type>          inner_iterator;
         typedef dlist_const_iterator<value_type >   const_inner_iterator;
@@ -274,6 +313,10 @@ namespace tools {
         typedef _reverse_iterator<const_iterator> const_reverse_iterator;
 
     public:
+        _Allocator get_allocator() const {
+            return allocator_type::get_allocator();
+        }
+
         bool empty() const {
             return head() == m_head;
         }
@@ -305,7 +348,7 @@ namespace tools {
         }
 
         reference back() {
-            return const_cast<reference >((const self_type*)this)->head();
+            return const_cast<reference >(((const self_type*)this)->back());
         }
 
         void clear() {
@@ -355,6 +398,12 @@ namespace tools {
             tail() = _insert_after(tail(),val);
         }
 
+        void swap(self_type& other) {
+            std::swap((allocator_type&) *this, (allocator_type&) other);
+            std::swap(m_head, other.m_head);
+            std::swap(m_tail, other.m_tail);
+        }
+
         iterator begin() {
             return inner_iterator(head());
         }
@@ -0,0 +1,648 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _FLAT_HASH_MAP_H_
+#define _FLAT_HASH_MAP_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "algorithm.h"
+#include "functor.h"
+#include "memory.h"
+#include "sequence.h"
+#include "type_base.h"
+
+namespace tools {
+
+	/*
+	 * One control byte per slot: _hash_empty, or the low 7 bits of the
+	 * hash of the slot's key. A group is 16 consecutive control bytes
+	 * matched in one SSE2 compare; the bytes of the first group are
+	 * mirrored past the end so any slot can start one.
+	 */
+	typedef int8_t _hash_ctrl;
+
+	enum { _hash_group_width = 16 };
+
+	static const _hash_ctrl _hash_empty = -128;
+
+#ifdef _TOOLS_SIMD_X86
+
+	class _hash_group {
+	private:
+		__m128i m_ctrl;
+
+	public:
+		explicit _hash_group(const _hash_ctrl* p) : m_ctrl(_mm_loadu_si128((const __m128i*) p)) { }
+
+		/* a bit per byte equal to h2 */
+		uint32_t match(_hash_ctrl h2) const {
+			return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)));
+		}
+
+		/* empty is the only negative control byte */
+		uint32_t match_empty() const { return uint32_t(_mm_movemask_epi8(m_ctrl)); }
+	};
+
+#else
+
+	class _hash_group {
+	private:
+		const _hash_ctrl* m_ctrl;
+
+	public:
+		explicit _hash_group(const _hash_ctrl* p) : m_ctrl(p) { }
+
+		uint32_t match(_hash_ctrl h2) const {
+			uint32_t mask = 0;
+			for (int i = 0; i < _hash_group_width; ++i) {
+				mask |= uint32_t(h2 == m_ctrl[i]) << i;
+			}
+			return mask;
+		}
+
+		uint32_t match_empty() const { return match(_hash_empty); }
+	};
+
+#endif //_TOOLS_SIMD_X86
+
+	template <typename _Hash, typename _Equal, typename = void>
+	struct _is_transparent_lookup : _false_type { };
+
+	template <typename _Hash, typename _Equal>
+	struct _is_transparent_lookup<
+		_Hash, _Equal, _void_t<typename _Hash::is_transparent, typename _Equal::is_transparent>
+	> : _true_type { };
+
+	/*
+	 * Open addressing with linear probing a group at a time. A key lives
+	 * at or after the slot its hash picks, with no empty slot in between;
+	 * erase keeps that true by shifting the following run back (Knuth's
+	 * algorithm R), so there are no tombstones and a lookup stops at the
+	 * first group holding an empty slot. At most 7/8 of the slots are in
+	 * use. Entries move on erase and on rehash, so values must move
+	 * without throwing.
+	 */
+	template <
+		typename _Key,
+		typename _Val,
+		typename _KeyOf,
+		typename _Hash,
+		typename _Equal,
+		typename _Allocator
+	>
+	class _flat_hash_table {
+	public:
+		typedef _Key        key_type;
+		typedef _Val        value_type;
+		typedef _Val*       pointer;
+		typedef const _Val* const_pointer;
+		typedef _Val&       reference;
+		typedef const _Val& const_reference;
+		typedef _Hash       hasher;
+		typedef _Equal      key_equal;
+
+		typedef size_t    size_type;
+		typedef ptrdiff_t difference_type;
+
+	protected:
+		typedef _flat_hash_table<_Key, _Val, _KeyOf, _Hash, _Equal, _Allocator> self_type;
+
+		typedef typename std::aligned_storage<sizeof (_Val), alignof (_Val)>::type _slot;
+
+		typedef sequence<_hash_ctrl, _Allocator> ctrl_sequence;
+		typedef sequence<_slot, _Allocator>      slot_sequence;
+
+		static constexpr size_type _npos = size_type(-1);
+
+		static_assert(std::is_nothrow_move_constructible<_Val>::value,
+		              "flat hash tables need values that move without throwing");
+
+	public:
+		template <bool _Const>
+		class _hash_iterator {
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef _Val                      value_type;
+			typedef ptrdiff_t                 difference_type;
+			typedef typename std::conditional<_Const, const _Val*, _Val*>::type pointer;
+			typedef typename std::conditional<_Const, const _Val&, _Val&>::type reference;
+
+		private:
+			const _hash_ctrl* m_ctrl;
+			const _hash_ctrl* m_last;
+			pointer           m_slot;
+
+			void _skip_empty() {
+				while (m_ctrl != m_last && _hash_empty == *m_ctrl) {
+					++m_ctrl;
+					++m_slot;
+				}
+			}
+
+		public:
+			_hash_iterator() : m_ctrl(nullptr), m_last(nullptr), m_slot(nullptr) { }
+			_hash_iterator(const _hash_ctrl* ctrl, const _hash_ctrl* last, pointer slot) :
+				m_ctrl(ctrl), m_last(last), m_slot(slot) {
+				_skip_empty();
+			}
+
+			/* iterator to const_iterator */
+			template <bool _Other, typename = typename std::enable_if<_Const && !_Other>::type>
+			_hash_iterator(const _hash_iterator<_Other>& other) :
+				m_ctrl(other.ctrl()), m_last(other.last()), m_slot(other.operator->()) { }
+
+		public:
+			const _hash_ctrl* ctrl() const { return m_ctrl; }
+			const _hash_ctrl* last() const { return m_last; }
+
+			reference operator*() const { return *m_slot; }
+			pointer operator->() const { return m_slot; }
+
+			_hash_iterator& operator++() {
+				++m_ctrl;
+				++m_slot;
+				_skip_empty();
+				return *this;
+			}
+
+			_hash_iterator operator++(int) { _hash_iterator tmp = *this; ++*this; return tmp; }
+
+			bool operator==(const _hash_iterator& other) const { return m_ctrl == other.m_ctrl; }
+			bool operator!=(const _hash_iterator& other) const { return m_ctrl != other.m_ctrl; }
+		};
+
+		typedef _hash_iterator<false> iterator;
+		typedef _hash_iterator<true>  const_iterator;
+
+	private:
+		ctrl_sequence m_ctrl;  /* capacity + group width bytes, the tail mirrors the head */
+		slot_sequence m_slots;
+		size_type     m_size;
+		hasher        m_hash;
+		key_equal     m_equal;
+
+	protected:
+		size_type _capacity() const { return m_slots.size(); }
+		size_type _mask() const { return _capacity() - 1; }
+
+		static size_type _max_load(size_type capacity) { return capacity - capacity / 8; }
+
+		static _hash_ctrl _h2(size_t hash) { return _hash_ctrl(hash & 0x7f); }
+		static size_t _h1(size_t hash) { return hash >> 7; }
+
+		_Val* _slot_at(size_type index) { return (_Val*) (m_slots.data() + index); }
+		const _Val* _slot_at(size_type index) const { return (const _Val*) (m_slots.data() + index); }
+
+		/* moves the value at src into raw storage at dst and ends src */
+		static void _relocate(_Val* dst, _Val* src) {
+			construct(dst, std::move(*src));
+			destroy(src);
+		}
+
+		void _set_ctrl(size_type index, _hash_ctrl ctrl) {
+			m_ctrl[index] = ctrl;
+			if (index < _hash_group_width - 1) {
+				m_ctrl[_capacity() + index] = ctrl;
+			}
+		}
+
+		template <typename _K>
+		size_type _find(const _K& key, size_t hash) const {
+			if (0 == m_size) {
+				return _npos;
+			}
+
+			_KeyOf key_of;
+			size_type pos = _h1(hash) & _mask();
+			while (true) {
+				_hash_group group(&m_ctrl[pos]);
+				for (uint32_t match = group.match(_h2(hash)); 0 != match; match &= match - 1) {
+					size_type index = (pos + __builtin_ctz(match)) & _mask();
+					if (m_equal(key_of(*_slot_at(index)), key)) {
+						return index;
+					}
+				}
+				if (0 != group.match_empty()) {
+					return _npos;
+				}
+				pos = (pos + _hash_group_width) & _mask();
+			}
+		}
+
+		size_type _find_empty(size_t hash) const {
+			size_type pos = _h1(hash) & _mask();
+			while (true) {
+				uint32_t empty = _hash_group(&m_ctrl[pos]).match_empty();
+				if (0 != empty) {
+					return (pos + __builtin_ctz(empty)) & _mask();
+				}
+				pos = (pos + _hash_group_width) & _mask();
+			}
+		}
+
+		void _rehash(size_type capacity) {
+			ctrl_sequence ctrl(capacity + _hash_group_width, m_ctrl.get_allocator());
+			slot_sequence slots(capacity, m_slots.get_allocator());
+			ctrl.resize(capacity + _hash_group_width);
+			slots.resize(capacity);
+			std::fill(ctrl.begin(), ctrl.end(), _hash_empty);
+
+			self_type fresh(m_hash, m_equal);
+			fresh.m_ctrl.swap(ctrl);
+			fresh.m_slots.swap(slots);
+
+			/* nothing below throws: hashing a stored key is taken not to */
+			_KeyOf key_of;
+			for (size_type i = 0; i < _capacity(); ++i) {
+				if (_hash_empty != m_ctrl[i]) {
+					_Val*  val   = _slot_at(i);
+					size_t hash  = m_hash(key_of(*val));
+					size_type at = fresh._find_empty(hash);
+					_relocate(fresh._slot_at(at), val);
+					fresh._set_ctrl(at, _h2(hash));
+				}
+			}
+			fresh.m_size = m_size;
+			std::fill(m_ctrl.begin(), m_ctrl.end(), _hash_empty);
+
+			m_ctrl.swap(fresh.m_ctrl);
+			m_slots.swap(fresh.m_slots);
+			fresh.m_size = 0;
+		}
+
+		static size_type _capacity_for(size_type n) {
+			size_type capacity = _hash_group_width;
+			while (_max_load(capacity) < n) {
+				capacity *= 2;
+			}
+			return capacity;
+		}
+
+		/* room for one more, returns false when that took a rehash */
+		bool _reserve_one() {
+			if (m_size < _max_load(_capacity())) {
+				return true;
+			}
+			_rehash(0 == _capacity() ? size_type(_hash_group_width) : _capacity() * 2);
+			return false;
+		}
+
+		/* index of the slot for key, constructed from args when key was absent */
+		template <typename _K, typename... _Args>
+		std::pair<size_type, bool> _emplace_key(const _K& key, _Args&&... args) {
+			size_t    hash  = m_hash(key);
+			size_type index = _find(key, hash);
+			if (_npos != index) {
+				return std::make_pair(index, false);
+			}
+
+			_reserve_one();
+			index = _find_empty(hash);
+			construct(_slot_at(index), std::forward<_Args>(args)...);
+			_set_ctrl(index, _h2(hash));
+			++m_size;
+			return std::make_pair(index, true);
+		}
+
+		void _erase_at(size_type index) {
+			destroy(_slot_at(index));
+			--m_size;
+
+			/* shift back every following entry that may sit in the hole */
+			_KeyOf    key_of;
+			size_type hole = index;
+			for (size_type next = (index + 1) & _mask(); _hash_empty != m_ctrl[next]; next = (next + 1) & _mask()) {
+				_Val*     val  = _slot_at(next);
+				size_type home = _h1(m_hash(key_of(*val))) & _mask();
+				if (((hole - home) & _mask()) < ((next - home) & _mask())) {
+					_relocate(_slot_at(hole), val);
+					_set_ctrl(hole, m_ctrl[next]);
+					hole = next;
+				}
+			}
+			_set_ctrl(hole, _hash_empty);
+		}
+
+		void _destroy_all() {
+			if (!std::is_trivially_destructible<_Val>::value) {
+				for (size_type i = 0; i < _capacity(); ++i) {
+					if (_hash_empty != m_ctrl[i]) {
+						destroy(_slot_at(i));
+					}
+				}
+			}
+		}
+
+		iterator _iterator_at(size_type index) {
+			return iterator(&m_ctrl[0] + index, &m_ctrl[0] + _capacity(), _slot_at(index));
+		}
+
+		const_iterator _iterator_at(size_type index) const {
+			return const_iterator(&m_ctrl[0] + index, &m_ctrl[0] + _capacity(), _slot_at(index));
+		}
+
+		size_type _index_of(const_iterator pos) const { return pos.ctrl() - &m_ctrl[0]; }
+
+		/* iterators are left to erase(const_iterator) */
+		template <typename _K>
+		using _enable_transparent = typename std::enable_if<
+			_is_transparent_lookup<_Hash, _Equal>::value && !std::is_convertible<_K, const_iterator>::value, _K
+		>::type;
+
+	public:
+		explicit _flat_hash_table(const hasher&     hash  = hasher()    ,
+		                          const key_equal&  equal = key_equal() ,
+		                          const _Allocator& alloc = _Allocator()) :
+			m_ctrl(alloc), m_slots(alloc), m_size(0), m_hash(hash), m_equal(equal) { }
+
+		_flat_hash_table(const self_type& other) :
+			m_ctrl(other.m_ctrl.get_allocator()), m_slots(other.m_slots.get_allocator()),
+			m_size(0), m_hash(other.m_hash), m_equal(other.m_equal) {
+			reserve(other.size());
+			for (const_iterator it = other.begin(); it != other.end(); ++it) {
+				insert(*it);
+			}
+		}
+
+		_flat_hash_table(self_type&& other) noexcept :
+			m_ctrl(std::move(other.m_ctrl)), m_slots(std::move(other.m_slots)),
+			m_size(other.m_size), m_hash(other.m_hash), m_equal(other.m_equal) {
+			other.m_size = 0;
+		}
+
+		~_flat_hash_table() { _destroy_all(); }
+
+		self_type& operator=(const self_type& other) {
+			if (this != &other) {
+				self_type tmp(other);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		self_type& operator=(self_type&& other) noexcept {
+			if (this != &other) {
+				self_type tmp(std::move(other));
+				swap(tmp);
+			}
+			return *this;
+		}
+
+	public:
+		iterator find(const key_type& key) {
+			size_type index = _find(key, m_hash(key));
+			return _npos == index ? end() : _iterator_at(index);
+		}
+
+		const_iterator find(const key_type& key) const {
+			size_type index = _find(key, m_hash(key));
+			return _npos == index ? end() : _iterator_at(index);
+		}
+
+		/* lookup by anything the hasher and key_equal take, when both are transparent */
+		template <typename _K, typename = _enable_transparent<_K> >
+		iterator find(const _K& key) {
+			size_type index = _find(key, m_hash(key));
+			return _npos == index ? end() : _iterator_at(index);
+		}
+
+		template <typename _K, typename = _enable_transparent<_K> >
+		const_iterator find(const _K& key) const {
+			size_type index = _find(key, m_hash(key));
+			return _npos == index ? end() : _iterator_at(index);
+		}
+
+		bool contains(const key_type& key) const { return _npos != _find(key, m_hash(key)); }
+
+		template <typename _K, typename = _enable_transparent<_K> >
+		bool contains(const _K& key) const { return _npos != _find(key, m_hash(key)); }
+
+		size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+		template <typename _K, typename = _enable_transparent<_K> >
+		size_type count(const _K& key) const { return contains(key) ? 1 : 0; }
+
+		std::pair<iterator, bool> insert(const value_type& val) {
+			std::pair<size_type, bool> result = _emplace_key(_KeyOf()(val), val);
+			return std::make_pair(_iterator_at(result.first), result.second);
+		}
+
+		std::pair<iterator, bool> insert(value_type&& val) {
+			std::pair<size_type, bool> result = _emplace_key(_KeyOf()(val), std::move(val));
+			return std::make_pair(_iterator_at(result.first), result.second);
+		}
+
+		template <typename _InputIterator>
+		void insert(_InputIterator first, _InputIterator last) {
+			for (; first != last; ++first) {
+				insert(*first);
+			}
+		}
+
+		/* the value is built first to learn its key, and dropped if the key is there */
+		template <typename... _Args>
+		std::pair<iterator, bool> emplace(_Args&&... args) {
+			value_type val(std::forward<_Args>(args)...);
+			return insert(std::move(val));
+		}
+
+		size_type erase(const key_type& key) {
+			size_type index = _find(key, m_hash(key));
+			if (_npos == index) {
+				return 0;
+			}
+			_erase_at(index);
+			return 1;
+		}
+
+		template <typename _K, typename = _enable_transparent<_K> >
+		size_type erase(const _K& key) {
+			size_type index = _find(key, m_hash(key));
+			if (_npos == index) {
+				return 0;
+			}
+			_erase_at(index);
+			return 1;
+		}
+
+		/* entries shift back on erase: pos may now hold a later entry, or pos + 1 an earlier one */
+		void erase(const_iterator pos) { _erase_at(_index_of(pos)); }
+
+		void clear() {
+			_destroy_all();
+			std::fill(m_ctrl.begin(), m_ctrl.end(), _hash_empty);
+			m_size = 0;
+		}
+
+		/* room for n entries without rehashing */
+		void reserve(size_type n) {
+			if (_max_load(_capacity()) < n || 0 == _capacity()) {
+				size_type capacity = _capacity_for(n);
+				if (_capacity() < capacity) {
+					_rehash(capacity);
+				}
+			}
+		}
+
+		/* smallest table that holds the entries */
+		void shrink_to_fit() {
+			size_type capacity = _capacity_for(m_size);
+			if (capacity < _capacity()) {
+				_rehash(capacity);
+			}
+		}
+
+	public:
+		hasher hash_function() const { return m_hash; }
+		key_equal key_eq() const { return m_equal; }
+		_Allocator get_allocator() const { return m_slots.get_allocator(); }
+
+		bool empty() const { return 0 == m_size; }
+		size_type size() const { return m_size; }
+		size_type max_size() const { return size_type(-1) / sizeof (_slot); }
+		size_type capacity() const { return _capacity(); }
+		float load_factor() const { return 0 == _capacity() ? 0.0f : float(m_size) / _capacity(); }
+
+		iterator begin() { return 0 == _capacity() ? iterator() : _iterator_at(0); }
+		const_iterator begin() const { return 0 == _capacity() ? const_iterator() : _iterator_at(0); }
+
+		iterator end() { return 0 == _capacity() ? iterator() : _iterator_at(_capacity()); }
+		const_iterator end() const { return 0 == _capacity() ? const_iterator() : _iterator_at(_capacity()); }
+
+		void swap(self_type& other) {
+			m_ctrl.swap(other.m_ctrl);
+			m_slots.swap(other.m_slots);
+			std::swap(m_size, other.m_size);
+			std::swap(m_hash, other.m_hash);
+			std::swap(m_equal, other.m_equal);
+		}
+	};
+
+	template <typename _Key, typename _Val, typename _KeyOf, typename _Hash, typename _Equal, typename _Allocator>
+	constexpr typename _flat_hash_table<_Key, _Val, _KeyOf, _Hash, _Equal, _Allocator>::size_type
+	_flat_hash_table<_Key, _Val, _KeyOf, _Hash, _Equal, _Allocator>::_npos;
+
+	/*
+	 * Values are std::pair<_Key, _Tp> rather than pair<const _Key, _Tp>:
+	 * they move on erase and on rehash. Keys reached through an iterator
+	 * must not be modified.
+	 */
+	template <
+		typename _Key,
+		typename _Tp,
+		typename _Hash      = hash<_Key>,
+		typename _Equal     = equal_to<_Key>,
+		typename _Allocator = std::allocator<std::pair<_Key, _Tp> >
+	>
+	class flat_hash_map : public _flat_hash_table<
+		_Key, std::pair<_Key, _Tp>, select_first<std::pair<_Key, _Tp> >, _Hash, _Equal, _Allocator
+	> {
+	protected:
+		typedef _flat_hash_table<
+			_Key, std::pair<_Key, _Tp>, select_first<std::pair<_Key, _Tp> >, _Hash, _Equal, _Allocator
+		> base_type;
+
+		typedef flat_hash_map<_Key, _Tp, _Hash, _Equal, _Allocator> self_type;
+
+	public:
+		typedef _Tp                              mapped_type;
+		typedef typename base_type::key_type     key_type;
+		typedef typename base_type::value_type   value_type;
+		typedef typename base_type::size_type    size_type;
+		typedef typename base_type::iterator     iterator;
+		typedef typename base_type::hasher       hasher;
+		typedef typename base_type::key_equal    key_equal;
+
+	public:
+		explicit flat_hash_map(const hasher&     hash  = hasher()    ,
+		                       const key_equal&  equal = key_equal() ,
+		                       const _Allocator& alloc = _Allocator()) :
+			base_type(hash, equal, alloc) { }
+
+		template <typename _InputIterator>
+		flat_hash_map(_InputIterator first, _InputIterator last) { this->insert(first, last); }
+
+	public:
+		/* constructs the mapped value from args only when key is absent */
+		template <typename... _Args>
+		std::pair<iterator, bool> try_emplace(const key_type& key, _Args&&... args) {
+			std::pair<size_type, bool> result = this->_emplace_key(
+				key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<_Args>(args)...)
+			);
+			return std::make_pair(this->_iterator_at(result.first), result.second);
+		}
+
+		template <typename... _Args>
+		std::pair<iterator, bool> try_emplace(key_type&& key, _Args&&... args) {
+			std::pair<size_type, bool> result = this->_emplace_key(
+				key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<_Args>(args)...)
+			);
+			return std::make_pair(this->_iterator_at(result.first), result.second);
+		}
+
+		template <typename _M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& key, _M&& val) {
+			std::pair<iterator, bool> result = try_emplace(key, std::forward<_M>(val));
+			if (!result.second) {
+				result.first->second = std::forward<_M>(val);
+			}
+			return result;
+		}
+
+		mapped_type& operator[](const key_type& key) { return try_emplace(key).first->second; }
+		mapped_type& operator[](key_type&& key) { return try_emplace(std::move(key)).first->second; }
+
+		mapped_type& at(const key_type& key) {
+			iterator it = this->find(key);
+			if (this->end() == it) {
+				throw std::out_of_range("flat_hash_map::at: no such key");
+			}
+			return it->second;
+		}
+
+		const mapped_type& at(const key_type& key) const {
+			typename base_type::const_iterator it = this->find(key);
+			if (this->end() == it) {
+				throw std::out_of_range("flat_hash_map::at: no such key");
+			}
+			return it->second;
+		}
+	};
+
+	/* keys reached through an iterator must not be modified */
+	template <
+		typename _Key,
+		typename _Hash      = hash<_Key>,
+		typename _Equal     = equal_to<_Key>,
+		typename _Allocator = std::allocator<_Key>
+	>
+	class flat_hash_set : public _flat_hash_table<_Key, _Key, self<_Key>, _Hash, _Equal, _Allocator> {
+	protected:
+		typedef _flat_hash_table<_Key, _Key, self<_Key>, _Hash, _Equal, _Allocator> base_type;
+
+	public:
+		typedef typename base_type::hasher    hasher;
+		typedef typename base_type::key_equal key_equal;
+
+	public:
+		explicit flat_hash_set(const hasher&     hash  = hasher()    ,
+		                       const key_equal&  equal = key_equal() ,
+		                       const _Allocator& alloc = _Allocator()) :
+			base_type(hash, equal, alloc) { }
+
+		template <typename _InputIterator>
+		flat_hash_set(_InputIterator first, _InputIterator last) { this->insert(first, last); }
+	};
+}
+
+#endif //_FLAT_HASH_MAP_H_
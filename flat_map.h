@@ -0,0 +1,409 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _FLAT_MAP_H_
+#define _FLAT_MAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "functor.h"
+#include "sequence.h"
+#include "sort.h"
+#include "type_base.h"
+
+namespace tools {
+
+	/* orders values by their keys */
+	template <typename _Val, typename _KeyOf, typename _Comparator>
+	struct _flat_value_compare {
+		_Comparator comp;
+
+		explicit _flat_value_compare(const _Comparator& comp) : comp(comp) { }
+
+		bool operator()(const _Val& left, const _Val& right) const {
+			_KeyOf key_of;
+			return comp(key_of(left), key_of(right));
+		}
+	};
+
+	/* equivalent values are indistinguishable, any sort keeps the right one */
+	template <typename _Key, typename _Val, typename _Comparator>
+	struct _flat_equivalent_is_equal : _bool_type<
+		std::is_same<_Key, _Val>::value && std::is_integral<_Key>::value &&
+		_sort_is_branchless<_Key, _Comparator>::value
+	> { };
+
+	/*
+	 * A sorted sequence with the lookup and insert interface of _rb_tree.
+	 * Elements sit next to each other with nothing but the payload, so a
+	 * lookup is a binary search over one array: the loop below picks the
+	 * next half with a conditional move, the only branch is the loop
+	 * itself. Single inserts and erases shift the tail, O(n); ranges are
+	 * appended, sorted and merged in once, O(n + m log m), so tables are
+	 * best built in bulk and then read. Values move when the sequence
+	 * shifts, any iterator is invalidated by an insert or an erase.
+	 */
+	template <
+		typename _Key,
+		typename _Val,
+		typename _KeyOf,
+		typename _Comparator,
+		typename _Allocator = std::allocator<_Val>
+	>
+	class _flat_tree {
+	protected:
+		typedef sequence<_Val, _Allocator> sequence_type;
+
+		typedef _flat_tree<_Key, _Val, _KeyOf, _Comparator, _Allocator> self_type;
+
+	public:
+		typedef _Key        key_type;
+		typedef _Val        value_type;
+		typedef _Val*       pointer;
+		typedef const _Val* const_pointer;
+		typedef _Val&       reference;
+		typedef const _Val& const_reference;
+		typedef size_t      size_type;
+		typedef ptrdiff_t   difference_type;
+
+		typedef _Comparator                                        comparator_type;
+		typedef _flat_value_compare<_Val, _KeyOf, _Comparator>     value_compare;
+
+		typedef typename sequence_type::iterator               iterator;
+		typedef typename sequence_type::const_iterator         const_iterator;
+		typedef typename sequence_type::reverse_iterator       reverse_iterator;
+		typedef typename sequence_type::const_reverse_iterator const_reverse_iterator;
+
+	protected:
+		sequence_type m_values;
+		_Comparator   m_comp;
+
+	protected:
+		/* first index whose key is not below key */
+		size_type _lower_index(const key_type& key) const {
+			size_type n = m_values.size();
+			if (0 == n) {
+				return 0;
+			}
+
+			_KeyOf key_of;
+			const _Val* first = m_values.data();
+			const _Val* base  = first;
+			while (1 < n) {
+				size_type half = n / 2;
+				base = m_comp(key_of(base[half]), key) ? base + half : base;
+				n -= half;
+			}
+			return (base - first) + m_comp(key_of(*base), key);
+		}
+
+		/* first index whose key is above key */
+		size_type _upper_index(const key_type& key) const {
+			size_type n = m_values.size();
+			if (0 == n) {
+				return 0;
+			}
+
+			_KeyOf key_of;
+			const _Val* first = m_values.data();
+			const _Val* base  = first;
+			while (1 < n) {
+				size_type half = n / 2;
+				base = m_comp(key, key_of(base[half])) ? base : base + half;
+				n -= half;
+			}
+			return (base - first) + !m_comp(key, key_of(*base));
+		}
+
+		void _sort_range(iterator first, iterator last, _true_type) {
+			tools::sort(first, last, m_comp);
+		}
+
+		void _sort_range(iterator first, iterator last, _false_type) {
+			std::stable_sort(first, last, value_comp());
+		}
+
+		/* appended values are sorted, then merged behind their equivalents already in place */
+		template <typename _InputIterator>
+		void _append_sorted(_InputIterator first, _InputIterator last) {
+			size_type old_size = m_values.size();
+			m_values.insert(m_values.end(), first, last);
+
+			iterator middle = m_values.begin() + old_size;
+			_sort_range(middle, m_values.end(), _flat_equivalent_is_equal<_Key, _Val, _Comparator>());
+			if (0 != old_size && middle != m_values.end() && value_comp()(*middle, *(middle - 1))) {
+				std::inplace_merge(m_values.begin(), middle, m_values.end(), value_comp());
+			}
+		}
+
+	public:
+		explicit _flat_tree(const _Comparator& comp  = _Comparator(),
+		                    const _Allocator&  alloc = _Allocator()) :
+			m_values(alloc), m_comp(comp) { }
+
+	public:
+		iterator begin() { return m_values.begin(); }
+		const_iterator begin() const { return m_values.begin(); }
+		const_iterator cbegin() const { return m_values.begin(); }
+
+		iterator end() { return m_values.end(); }
+		const_iterator end() const { return m_values.end(); }
+		const_iterator cend() const { return m_values.end(); }
+
+		reverse_iterator rbegin() { return m_values.rbegin(); }
+		const_reverse_iterator rbegin() const { return m_values.rbegin(); }
+
+		reverse_iterator rend() { return m_values.rend(); }
+		const_reverse_iterator rend() const { return m_values.rend(); }
+
+		bool empty() const { return m_values.empty(); }
+		size_type size() const { return m_values.size(); }
+		size_type max_size() const { return m_values.max_size(); }
+		size_type capacity() const { return m_values.capacity(); }
+
+		void reserve(size_type n) { m_values.reserve(n); }
+		/* a table built once can drop its growth slack */
+		void shrink_to_fit() { m_values.shrink_to_fit(); }
+		void clear() { m_values.clear(); }
+
+		comparator_type key_comp() const { return m_comp; }
+		value_compare value_comp() const { return value_compare(m_comp); }
+
+		const_pointer data() const { return m_values.data(); }
+
+		const_reference operator[](size_type index) const { return m_values[index]; }
+
+		const_iterator minimum() const { return m_values.begin(); }
+
+		const_iterator maximum() const {
+			return empty() ? m_values.end() : m_values.end() - 1;
+		}
+
+	public:
+		std::pair<iterator, bool> insert_unique(const value_type& val) {
+			_KeyOf key_of;
+			size_type index = _lower_index(key_of(val));
+			if (index != size() && !m_comp(key_of(val), key_of(m_values[index]))) {
+				return std::pair<iterator, bool>(begin() + index, false);
+			}
+			return std::pair<iterator, bool>(m_values.insert(begin() + index, val), true);
+		}
+
+		std::pair<iterator, bool> insert_unique(value_type&& val) {
+			_KeyOf key_of;
+			size_type index = _lower_index(key_of(val));
+			if (index != size() && !m_comp(key_of(val), key_of(m_values[index]))) {
+				return std::pair<iterator, bool>(begin() + index, false);
+			}
+			return std::pair<iterator, bool>(m_values.insert(begin() + index, std::move(val)), true);
+		}
+
+		/* equivalent values keep their insertion order */
+		iterator insert_equal(const value_type& val) {
+			return m_values.insert(begin() + _upper_index(_KeyOf()(val)), val);
+		}
+
+		iterator insert_equal(value_type&& val) {
+			size_type index = _upper_index(_KeyOf()(val));
+			return m_values.insert(begin() + index, std::move(val));
+		}
+
+		/* bulk build: append, sort, merge, then drop every value whose key was already there */
+		template <typename _InputIterator>
+		void insert_unique(_InputIterator first, _InputIterator last) {
+			_append_sorted(first, last);
+
+			value_compare comp = value_comp();
+			m_values.erase(
+				std::unique(m_values.begin(), m_values.end(), [&comp](const _Val& left, const _Val& right) {
+					return !comp(left, right);
+				}),
+				m_values.end()
+			);
+		}
+
+		template <typename _InputIterator>
+		void insert_equal(_InputIterator first, _InputIterator last) { _append_sorted(first, last); }
+
+		iterator erase(const_iterator pos) { return m_values.erase(pos); }
+		iterator erase(const_iterator first, const_iterator last) { return m_values.erase(first, last); }
+
+		size_type erase(const key_type& key) {
+			std::pair<iterator, iterator> range = equal_range(key);
+			size_type count = range.second - range.first;
+			m_values.erase(range.first, range.second);
+			return count;
+		}
+
+		iterator find(const key_type& key) {
+			size_type index = _lower_index(key);
+			return (index == size() || m_comp(key, _KeyOf()(m_values[index]))) ? end() : begin() + index;
+		}
+
+		const_iterator find(const key_type& key) const {
+			size_type index = _lower_index(key);
+			return (index == size() || m_comp(key, _KeyOf()(m_values[index]))) ? end() : begin() + index;
+		}
+
+		bool contains(const key_type& key) const { return end() != find(key); }
+
+		size_type count(const key_type& key) const { return _upper_index(key) - _lower_index(key); }
+
+		iterator lower_bound(const key_type& key) { return begin() + _lower_index(key); }
+		const_iterator lower_bound(const key_type& key) const { return begin() + _lower_index(key); }
+
+		iterator upper_bound(const key_type& key) { return begin() + _upper_index(key); }
+		const_iterator upper_bound(const key_type& key) const { return begin() + _upper_index(key); }
+
+		std::pair<iterator, iterator> equal_range(const key_type& key) {
+			return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+			return std::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+		}
+
+		void swap(self_type& other) {
+			m_values.swap(other.m_values);
+			std::swap(m_comp, other.m_comp);
+		}
+	};
+
+	template <typename _Key, typename _Val, typename _KeyOf, typename _Comparator, typename _Allocator>
+	inline void swap(_flat_tree<_Key, _Val, _KeyOf, _Comparator, _Allocator>& left,
+	                 _flat_tree<_Key, _Val, _KeyOf, _Comparator, _Allocator>& right) {
+		left.swap(right);
+	}
+
+	/* keys reached through an iterator must not be modified */
+	template <
+		typename _Key,
+		typename _Comparator = less<_Key>,
+		typename _Allocator  = std::allocator<_Key>
+	>
+	class flat_set : public _flat_tree<_Key, _Key, self<_Key>, _Comparator, _Allocator> {
+	protected:
+		typedef _flat_tree<_Key, _Key, self<_Key>, _Comparator, _Allocator> base_type;
+
+	public:
+		typedef typename base_type::value_type value_type;
+		typedef typename base_type::iterator   iterator;
+
+	public:
+		explicit flat_set(const _Comparator& comp  = _Comparator(),
+		                  const _Allocator&  alloc = _Allocator()) :
+			base_type(comp, alloc) { }
+
+		template <typename _InputIterator>
+		flat_set(_InputIterator first, _InputIterator last) { this->insert_unique(first, last); }
+
+		flat_set(std::initializer_list<value_type> values) { this->insert_unique(values.begin(), values.end()); }
+
+	public:
+		std::pair<iterator, bool> insert(const value_type& val) { return this->insert_unique(val); }
+		std::pair<iterator, bool> insert(value_type&& val) { return this->insert_unique(std::move(val)); }
+
+		template <typename _InputIterator>
+		void insert(_InputIterator first, _InputIterator last) { this->insert_unique(first, last); }
+	};
+
+	/*
+	 * Values are std::pair<_Key, _Tp> rather than pair<const _Key, _Tp>:
+	 * they move when the sequence shifts. Keys reached through an
+	 * iterator must not be modified.
+	 */
+	template <
+		typename _Key,
+		typename _Tp,
+		typename _Comparator = less<_Key>,
+		typename _Allocator  = std::allocator<std::pair<_Key, _Tp> >
+	>
+	class flat_map : public _flat_tree<
+		_Key, std::pair<_Key, _Tp>, select_first<std::pair<_Key, _Tp> >, _Comparator, _Allocator
+	> {
+	protected:
+		typedef _flat_tree<
+			_Key, std::pair<_Key, _Tp>, select_first<std::pair<_Key, _Tp> >, _Comparator, _Allocator
+		> base_type;
+
+	public:
+		typedef _Tp                                  mapped_type;
+		typedef typename base_type::key_type         key_type;
+		typedef typename base_type::value_type       value_type;
+		typedef typename base_type::size_type        size_type;
+		typedef typename base_type::iterator         iterator;
+		typedef typename base_type::const_iterator   const_iterator;
+
+	public:
+		explicit flat_map(const _Comparator& comp  = _Comparator(),
+		                  const _Allocator&  alloc = _Allocator()) :
+			base_type(comp, alloc) { }
+
+		/* for equal keys the first pair in the range wins, as with repeated insert */
+		template <typename _InputIterator>
+		flat_map(_InputIterator first, _InputIterator last) { this->insert_unique(first, last); }
+
+		flat_map(std::initializer_list<value_type> values) { this->insert_unique(values.begin(), values.end()); }
+
+	public:
+		std::pair<iterator, bool> insert(const value_type& val) { return this->insert_unique(val); }
+		std::pair<iterator, bool> insert(value_type&& val) { return this->insert_unique(std::move(val)); }
+
+		template <typename _InputIterator>
+		void insert(_InputIterator first, _InputIterator last) { this->insert_unique(first, last); }
+
+		/* constructs the mapped value from args only when key is absent */
+		template <typename... _Args>
+		std::pair<iterator, bool> try_emplace(const key_type& key, _Args&&... args) {
+			size_type index = this->_lower_index(key);
+			if (index != this->size() && !this->m_comp(key, this->m_values[index].first)) {
+				return std::pair<iterator, bool>(this->begin() + index, false);
+			}
+			return std::pair<iterator, bool>(
+				this->m_values.emplace(
+					this->begin() + index, std::piecewise_construct,
+					std::forward_as_tuple(key), std::forward_as_tuple(std::forward<_Args>(args)...)
+				),
+				true
+			);
+		}
+
+		template <typename _M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& key, _M&& val) {
+			std::pair<iterator, bool> result = try_emplace(key, std::forward<_M>(val));
+			if (!result.second) {
+				result.first->second = std::forward<_M>(val);
+			}
+			return result;
+		}
+
+		mapped_type& operator[](const key_type& key) { return try_emplace(key).first->second; }
+
+		mapped_type& at(const key_type& key) {
+			iterator it = this->find(key);
+			if (this->end() == it) {
+				throw std::out_of_range("flat_map::at: no such key");
+			}
+			return it->second;
+		}
+
+		const mapped_type& at(const key_type& key) const {
+			const_iterator it = this->find(key);
+			if (this->end() == it) {
+				throw std::out_of_range("flat_map::at: no such key");
+			}
+			return it->second;
+		}
+	};
+}
+
+#endif //_FLAT_MAP_H_
@@ -5,6 +5,13 @@
 #ifndef _FUNCTOR_H_
 #define _FUNCTOR_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+
 namespace tools {
 
 	template <typename _TpL, typename _TpR = _TpL>
@@ -21,6 +28,31 @@ namespace tools {
 		}
 	};
 
+	template <typename _TpL, typename _TpR = _TpL>
+	struct equal_to {
+		bool operator()(const _TpL& left, const _TpR& right) const {
+			return left == right;
+		}
+	};
+
+	/* string keys compare against C strings without building a std::string */
+	template <>
+	struct equal_to<std::string, std::string> {
+		typedef void is_transparent;
+
+		template <typename _TpL, typename _TpR>
+		bool operator()(const _TpL& left, const _TpR& right) const {
+			return left == right;
+		}
+	};
+
+	template <typename _Tp>
+	struct plus {
+		_Tp operator()(const _Tp& left, const _Tp& right) const {
+			return left + right;
+		}
+	};
+
 	/* mappings */
 
 	template <typename _Tp>
@@ -28,6 +60,70 @@ namespace tools {
 		const _Tp& operator()(const _Tp& val) const { return val; }
 	};
 
+	template <typename _Pair>
+	struct select_first {
+		const typename _Pair::first_type& operator()(const _Pair& val) const { return val.first; }
+	};
+
+	/*
+	 * hashing: every bit of the result depends on every bit of the key,
+	 * open addressing tables use both the low and the high bits.
+	 */
+
+	inline size_t _hash_mix(uint64_t x) {
+		x ^= x >> 32;
+		x *= 0xd6e8feb86659fd93ull;
+		x ^= x >> 32;
+		x *= 0xd6e8feb86659fd93ull;
+		x ^= x >> 32;
+		return size_t(x);
+	}
+
+	inline size_t _hash_bytes(const void* data, size_t length) {
+		const unsigned char* p = (const unsigned char*) data;
+		uint64_t h = 0x9e3779b97f4a7c15ull ^ length;
+		for (; 8 <= length; p += 8, length -= 8) {
+			uint64_t word;
+			memcpy(&word, p, 8);
+			h = (h ^ word) * 0xff51afd7ed558ccdull;
+			h ^= h >> 29;
+		}
+		uint64_t tail = 0;
+		memcpy(&tail, p, length);
+		return _hash_mix(h ^ tail);
+	}
+
+	template <typename _Tp>
+	struct _hash_is_direct : std::integral_constant<bool,
+		std::is_integral<_Tp>::value || std::is_enum<_Tp>::value || std::is_pointer<_Tp>::value> { };
+
+	template <typename _Tp, bool = _hash_is_direct<_Tp>::value>
+	struct _hash_base {
+		size_t operator()(const _Tp& val) const { return _hash_mix(uint64_t(val)); }
+	};
+
+	/* anything else goes through std::hash, which may be the identity */
+	template <typename _Tp>
+	struct _hash_base<_Tp, false> {
+		size_t operator()(const _Tp& val) const { return _hash_mix(std::hash<_Tp>()(val)); }
+	};
+
+	template <typename _Tp>
+	struct _hash_base<_Tp*, true> {
+		size_t operator()(_Tp* val) const { return _hash_mix(uint64_t(uintptr_t(val))); }
+	};
+
+	template <typename _Tp>
+	struct hash : _hash_base<_Tp> { };
+
+	template <>
+	struct hash<std::string> {
+		typedef void is_transparent;
+
+		size_t operator()(const std::string& val) const { return _hash_bytes(val.data(), val.size()); }
+		size_t operator()(const char* val) const { return _hash_bytes(val, strlen(val)); }
+	};
+
 }
 
 #endif //_FUNCTOR_H_
@@ -7,6 +7,7 @@
 
 #include "functor.h"
 #include "iterator.h"
+#include "sequence.h"
 
 namespace tools {
 
@@ -79,6 +80,7 @@ namespace tools {
 	                         _Difference           length,
 	                         _ValueType            value ,
 							 _Comparator           comp  ) {
+		_Difference top   = hole;
 		_Difference child = hole * 2 + 2;
 
 		while (child < length) {
@@ -95,7 +97,8 @@ namespace tools {
 			hole = child - 1;
 		}
 
-		*(base + hole) = value;
+		/* the hole sank to a leaf, value may belong higher up */
+		_push_heap(base, hole, top, value, comp);
 	};
 
 	template <typename _RandomAccessIterator, typename _Comparator>
@@ -133,12 +136,6 @@ namespace tools {
 		}
 	}
 
-	template <
-		typename _Val,
-		typename _Allocator
-	>
-	class sequence;
-
 	template <
 		typename _Val,
 		typename _Container  = sequence<_Val>,
@@ -0,0 +1,109 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _HUGE_PAGE_ALLOC_H_
+#define _HUGE_PAGE_ALLOC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace tools {
+
+	/*
+	 * Serves allocations of at least threshold bytes from their own
+	 * mappings, rounded up to whole huge pages. Explicit hugetlbfs pages
+	 * are tried first when asked for, then an aligned anonymous mapping
+	 * with transparent huge pages requested through madvise. Smaller
+	 * allocations go to operator new.
+	 */
+	class huge_page_alloc {
+	public:
+		enum { _huge_page_size = 2 * 1024 * 1024 };
+
+	private:
+		size_t m_threshold;
+		bool   m_hugetlbfs;
+
+	private:
+		static size_t _round_up(size_t n) {
+			return (n + _huge_page_size - 1) & ~size_t(_huge_page_size - 1);
+		}
+
+		void* _map_hugetlbfs(size_t length) const {
+#ifdef MAP_HUGETLB
+			void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+			               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (MAP_FAILED != p) {
+				return p;
+			}
+#endif
+			return nullptr;
+		}
+
+		void* _map_transparent(size_t length) const {
+			/* over-map so the region starts on a huge page boundary */
+			size_t padded = length + _huge_page_size;
+			void* p = mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+			               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (MAP_FAILED == p) {
+				throw std::bad_alloc();
+			}
+
+			uintptr_t raw     = (uintptr_t) p;
+			uintptr_t aligned = (raw + _huge_page_size - 1) & ~uintptr_t(_huge_page_size - 1);
+			if (raw != aligned) {
+				munmap(p, aligned - raw);
+			}
+			size_t tail = raw + padded - (aligned + length);
+			if (0 != tail) {
+				munmap((void*) (aligned + length), tail);
+			}
+
+#ifdef MADV_HUGEPAGE
+			madvise((void*) aligned, length, MADV_HUGEPAGE);
+#endif
+			return (void*) aligned;
+		}
+
+	public:
+		explicit huge_page_alloc(size_t threshold = _huge_page_size,
+		                         bool   hugetlbfs = false) :
+			m_threshold(threshold), m_hugetlbfs(hugetlbfs) { }
+
+	public:
+		void* allocate(size_t n) {
+			if (n < m_threshold) {
+				return ::operator new(n);
+			}
+
+			size_t length = _round_up(n);
+			void* p = m_hugetlbfs ? _map_hugetlbfs(length) : nullptr;
+			return nullptr != p ? p : _map_transparent(length);
+		}
+
+		size_t good_size(size_t n) const {
+			return n < m_threshold ? n : _round_up(n);
+		}
+
+		void deallocate(void* p, size_t n) {
+			if (nullptr == p) {
+				return;
+			}
+
+			if (n < m_threshold) {
+				::operator delete(p);
+				return;
+			}
+			munmap(p, _round_up(n));
+		}
+
+		size_t threshold() const { return m_threshold; }
+		bool hugetlbfs() const { return m_hugetlbfs; }
+	};
+}
+
+#endif //_HUGE_PAGE_ALLOC_H_
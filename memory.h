@@ -5,8 +5,15 @@
 #ifndef _MEMORY_H_
 #define _MEMORY_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.h"
+#include "type_base.h"
 
 namespace tools {
 
@@ -20,58 +27,524 @@ namespace tools {
 		new (ptr) _T(std::forward<_Args>(args)...);
 	};
 
-	template <typename _InputIterator, typename... _Args>
-	inline void construct(_InputIterator first,
-	                      _InputIterator last,
-	                      _Args&&...     args) {
+	template <typename _T>
+	inline void destroy(_T* ptr) {
+		ptr->~_T();
+	}
+
+	/* raw pointer ranges over trivially copyable values can be handled bytewise */
+
+	template <typename _Iterator>
+	struct _is_bitwise_range : _false_type { };
+
+	template <typename _T>
+	struct _is_bitwise_range<_T*> : _is_trivially_copyable<_T> { };
+
+	template <typename _InputIterator, typename _OutputIterator>
+	struct _is_bitwise_copy : _false_type { };
+
+	template <typename _T>
+	struct _is_bitwise_copy<_T*, _T*> : _is_trivially_copyable<_T> { };
+
+	template <typename _T>
+	struct _is_bitwise_copy<const _T*, _T*> : _is_trivially_copyable<_T> { };
+
+	/* destroy [first, last) */
+
+	template <typename _ForwardIterator>
+	inline void _destroy_range(_ForwardIterator, _ForwardIterator, _true_type) { }
+
+	template <typename _ForwardIterator>
+	inline void _destroy_range(_ForwardIterator first,
+	                           _ForwardIterator last ,
+	                           _false_type           ) {
 		while (first != last) {
-			construct(&(*first), std::forward<_Args>(args)...);
+			destroy(&(*first));
 			++first;
 		}
+	}
+
+	template <typename _ForwardIterator>
+	inline void destroy(_ForwardIterator first,
+	                    _ForwardIterator last ) {
+		typedef typename
+			_iterator_traits<_ForwardIterator>::value_type
+		value_type;
+
+		_destroy_range(first, last, _is_trivially_destructible<value_type>());
+	}
+
+	/* construct every element of [first, last) from args */
+
+	template <typename _T, typename... _Args>
+	inline void _construct_range(_T*        first,
+	                             _T*        last ,
+	                             _true_type      ,
+	                             _Args&&... args ) {
+		if (first == last) {
+			return;
+		}
+
+		construct(first, std::forward<_Args>(args)...);
+		if (1 == sizeof (_T)) {
+			memset(first + 1, *(const unsigned char*) first, last - first - 1);
+			return;
+		}
+		for (_T* cursor = first + 1; cursor != last; ++cursor) {
+			memcpy(cursor, first, sizeof (_T));
+		}
+	}
+
+	template <typename _ForwardIterator, typename... _Args>
+	inline void _construct_range(_ForwardIterator first,
+	                             _ForwardIterator last ,
+	                             _false_type           ,
+	                             _Args&&...       args ) {
+		_ForwardIterator cursor = first;
+		try {
+			while (cursor != last) {
+				construct(&(*cursor), args...);
+				++cursor;
+			}
+		}
+		catch (...) {
+			destroy(first, cursor);
+			throw;
+		}
+	}
+
+	template <typename _ForwardIterator, typename... _Args>
+	inline void construct(_ForwardIterator first,
+	                      _ForwardIterator last,
+	                      _Args&&...       args) {
+		_construct_range(
+			first, last, _is_bitwise_range<_ForwardIterator>(), std::forward<_Args>(args)...
+		);
 	};
 
+	/* copy/move [first, last) into raw storage at result, returns the end of the copy */
+
+	template <typename _InputIterator, typename _T>
+	inline _T* _uninitialized_copy(_InputIterator first,
+	                               _InputIterator last ,
+	                               _T*            result,
+	                               _true_type           ) {
+		size_t n = last - first;
+		if (0 != n) {
+			memcpy(result, first, n * sizeof (_T));
+		}
+		return result + n;
+	}
+
+	template <typename _InputIterator, typename _ForwardIterator>
+	inline _ForwardIterator _uninitialized_copy(_InputIterator   first ,
+	                                            _InputIterator   last  ,
+	                                            _ForwardIterator result,
+	                                            _false_type            ) {
+		_ForwardIterator cursor = result;
+		try {
+			while (first != last) {
+				construct(&(*cursor), *first);
+				++first;
+				++cursor;
+			}
+		}
+		catch (...) {
+			destroy(result, cursor);
+			throw;
+		}
+		return cursor;
+	}
+
+	template <typename _InputIterator, typename _ForwardIterator>
+	inline _ForwardIterator uninitialized_copy(_InputIterator   first ,
+	                                           _InputIterator   last  ,
+	                                           _ForwardIterator result) {
+		return _uninitialized_copy(
+			first, last, result, _is_bitwise_copy<_InputIterator, _ForwardIterator>()
+		);
+	}
+
+	template <typename _InputIterator, typename _ForwardIterator>
+	inline _ForwardIterator _uninitialized_move(_InputIterator   first ,
+	                                            _InputIterator   last  ,
+	                                            _ForwardIterator result,
+	                                            _true_type             ) {
+		return _uninitialized_copy(first, last, result, _true_type());
+	}
+
+	template <typename _InputIterator, typename _ForwardIterator>
+	inline _ForwardIterator _uninitialized_move(_InputIterator   first ,
+	                                            _InputIterator   last  ,
+	                                            _ForwardIterator result,
+	                                            _false_type            ) {
+		_ForwardIterator cursor = result;
+		try {
+			while (first != last) {
+				construct(&(*cursor), std::move(*first));
+				++first;
+				++cursor;
+			}
+		}
+		catch (...) {
+			destroy(result, cursor);
+			throw;
+		}
+		return cursor;
+	}
+
+	template <typename _InputIterator, typename _ForwardIterator>
+	inline _ForwardIterator uninitialized_move(_InputIterator   first ,
+	                                           _InputIterator   last  ,
+	                                           _ForwardIterator result) {
+		return _uninitialized_move(
+			first, last, result, _is_bitwise_copy<_InputIterator, _ForwardIterator>()
+		);
+	}
+
+	/* moves when that cannot throw (or copying is impossible), copies otherwise */
+
+	template <typename _InputIterator, typename _ForwardIterator>
+	inline _ForwardIterator _uninitialized_move_if_noexcept(_InputIterator   first ,
+	                                                        _InputIterator   last  ,
+	                                                        _ForwardIterator result,
+	                                                        _true_type             ) {
+		return tools::uninitialized_move(first, last, result);
+	}
+
+	template <typename _InputIterator, typename _ForwardIterator>
+	inline _ForwardIterator _uninitialized_move_if_noexcept(_InputIterator   first ,
+	                                                        _InputIterator   last  ,
+	                                                        _ForwardIterator result,
+	                                                        _false_type            ) {
+		return tools::uninitialized_copy(first, last, result);
+	}
+
+	template <typename _InputIterator, typename _ForwardIterator>
+	inline _ForwardIterator uninitialized_move_if_noexcept(_InputIterator   first ,
+	                                                       _InputIterator   last  ,
+	                                                       _ForwardIterator result) {
+		typedef typename
+			_iterator_traits<_InputIterator>::value_type
+		value_type;
+
+		return _uninitialized_move_if_noexcept(
+			first, last, result,
+			_bool_type<std::is_nothrow_move_constructible<value_type>::value ||
+			           !std::is_copy_constructible<value_type>::value>()
+		);
+	}
+
+	/*
+	 * relocate: move [first, last) to raw storage and end the lifetime of
+	 * the source. relocate walks forward and is safe when result <= first,
+	 * relocate_backward walks backward and is safe when d_last >= last.
+	 * Element by element it is a move and a destroy, a move that throws
+	 * halfway leaves holes in the source: only shift live elements with
+	 * it when _shifts_by_relocation holds.
+	 */
+
 	template <typename _T>
-	inline void destroy(_T* ptr) {
-		ptr->~_T();
+	inline _T* _relocate(_T* first, _T* last, _T* result, _true_type) {
+		size_t n = last - first;
+		if (0 != n) {
+			memmove(result, first, n * sizeof (_T));
+		}
+		return result + n;
 	}
 
-	template <typename _InputIterator>
-	inline void destroy(_InputIterator first,
-	                    _InputIterator last) {
+	template <typename _T>
+	inline _T* _relocate(_T* first, _T* last, _T* result, _false_type) {
 		while (first != last) {
-			destroy(&(*first));
+			construct(result, std::move(*first));
+			destroy(first);
 			++first;
+			++result;
 		}
+		return result;
 	}
 
+	template <typename _T>
+	inline _T* relocate(_T* first, _T* last, _T* result) {
+		return _relocate(first, last, result, _is_trivially_relocatable<_T>());
+	}
+
+	template <typename _T>
+	inline _T* _relocate_backward(_T* first, _T* last, _T* d_last, _true_type) {
+		size_t n = last - first;
+		if (0 != n) {
+			memmove(d_last - n, first, n * sizeof (_T));
+		}
+		return d_last - n;
+	}
+
+	template <typename _T>
+	inline _T* _relocate_backward(_T* first, _T* last, _T* d_last, _false_type) {
+		while (first != last) {
+			--last;
+			--d_last;
+			construct(d_last, std::move(*last));
+			destroy(last);
+		}
+		return d_last;
+	}
+
+	template <typename _T>
+	inline _T* relocate_backward(_T* first, _T* last, _T* d_last) {
+		return _relocate_backward(first, last, d_last, _is_trivially_relocatable<_T>());
+	}
+
+	/* in-place shifts may relocate, nothing can throw halfway through them */
+	template <typename _T>
+	struct _shifts_by_relocation : _bool_type<std::is_nothrow_move_constructible<_T>::value> { };
+
+	/*
+	 * opens a slot at p by shifting [p, end) up by one into the raw slot
+	 * at end, then moves val into p. p < end. With throwing moves the
+	 * tail shifts by assignment, as std::vector does: if that throws the
+	 * raw slot at end is raw again and [p, end) is still live.
+	 */
+	template <typename _T>
+	inline void _insert_shifting(_T* p, _T* end, _T& val, _true_type) {
+		relocate_backward(p, end, end + 1);
+		construct(p, std::move(val));
+	}
+
+	template <typename _T>
+	inline void _insert_shifting(_T* p, _T* end, _T& val, _false_type) {
+		construct(end, std::move(*(end - 1)));
+		try {
+			std::move_backward(p, end - 1, end);
+			*p = std::move(val);
+		}
+		catch (...) {
+			destroy(end);
+			throw;
+		}
+	}
+
+	template <typename _T>
+	inline void _insert_shifting(_T* p, _T* end, _T& val) {
+		_insert_shifting(p, end, val, _shifts_by_relocation<_T>());
+	}
+
+	/*
+	 * destroys [first, last) and shifts [last, end) down over it, returns
+	 * the new end. With throwing moves the tail shifts by assignment, if
+	 * that throws [first, end) is still live.
+	 */
+	template <typename _T>
+	inline _T* _erase_shifting(_T* first, _T* last, _T* end, _true_type) {
+		destroy(first, last);
+		return relocate(last, end, first);
+	}
+
+	template <typename _T>
+	inline _T* _erase_shifting(_T* first, _T* last, _T* end, _false_type) {
+		_T* new_end = std::move(last, end, first);
+		destroy(new_end, end);
+		return new_end;
+	}
+
+	template <typename _T>
+	inline _T* _erase_shifting(_T* first, _T* last, _T* end) {
+		return _erase_shifting(first, last, end, _shifts_by_relocation<_T>());
+	}
+
+	/*
+	 * removes the elements of [first, end) matching pred and compacts the
+	 * rest, end is updated also when pred throws. Survivors move in runs,
+	 * one relocate per run between two removed elements.
+	 */
+	template <typename _T, typename _Predicate>
+	inline void _erase_if_shifting(_T* first, _T*& end, _Predicate& pred, _true_type) {
+		_T* kept = first; /* end of the compacted prefix */
+		_T* run  = first; /* first survivor not moved yet */
+
+		try {
+			for (_T* p = first; p != end; ++p) {
+				if (pred(*p)) {
+					kept = kept == run ? p : relocate(run, p, kept);
+					destroy(p);
+					run = p + 1;
+				}
+			}
+		}
+		catch (...) {
+			end = kept == run ? end : relocate(run, end, kept);
+			throw;
+		}
+
+		end = kept == run ? end : relocate(run, end, kept);
+	}
+
+	template <typename _T, typename _Predicate>
+	inline void _erase_if_shifting(_T* first, _T*& end, _Predicate& pred, _false_type) {
+		_T* new_end = std::remove_if(first, end, [&pred](_T& val) { return pred(val); });
+		destroy(new_end, end);
+		end = new_end;
+	}
+
+	template <typename _T, typename _Predicate>
+	inline void _erase_if_shifting(_T* first, _T*& end, _Predicate& pred) {
+		_erase_if_shifting(first, end, pred, _shifts_by_relocation<_T>());
+	}
+
+	/*
+	 * moves [first, last) to fresh storage at result, leaving a gap of
+	 * gap slots before mid. the source is destroyed only once every
+	 * element made it across, so a throwing copy leaves it intact.
+	 */
+	template <typename _T>
+	inline _T* _relocate_with_gap(_T* first, _T* mid, _T* last,
+	                              _T* result, size_t gap, _true_type) {
+		_T* p = relocate(first, mid, result);
+		return relocate(mid, last, p + gap);
+	}
+
+	template <typename _T>
+	inline _T* _relocate_with_gap(_T* first, _T* mid, _T* last,
+	                              _T* result, size_t gap, _false_type) {
+		_T* p = tools::uninitialized_move_if_noexcept(first, mid, result);
+		_T* q = nullptr;
+		try {
+			q = tools::uninitialized_move_if_noexcept(mid, last, p + gap);
+		}
+		catch (...) {
+			destroy(result, p);
+			throw;
+		}
+		destroy(first, last);
+		return q;
+	}
+
+	template <typename _T>
+	inline _T* _relocate_with_gap(_T* first, _T* mid, _T* last, _T* result, size_t gap) {
+		return _relocate_with_gap(
+			first, mid, last, result, gap, _is_trivially_relocatable<_T>()
+		);
+	}
+
+	/* allocators whose deallocate is a no-op and which free in bulk */
+	template <typename _Alloc>
+	struct _is_monotonic_alloc : _false_type { };
+
+	/* nodes need neither destructor calls nor deallocation on teardown */
+	template <typename _Val, typename _Alloc>
+	struct _trivial_teardown :
+		_bool_type<_is_monotonic_alloc<_Alloc>::value &&
+		           _is_trivially_destructible<_Val>::value> { };
+
+	/*
+	 * standard_alloc talks to its allocator in bytes. Allocators with a
+	 * value_type (std::allocator and friends) are rebound to char, the
+	 * allocators in tools are byte allocators already.
+	 */
+	template <typename _Alloc, typename = void>
+	struct _byte_allocator {
+		typedef _Alloc type;
+	};
+
+	template <typename _Alloc>
+	struct _byte_allocator<_Alloc, _void_t<typename _Alloc::value_type>> {
+		typedef typename
+			std::allocator_traits<_Alloc>::template rebind_alloc<char>
+		type;
+	};
+
+	/*
+	 * Bytes an allocator really hands out for a request of n bytes. Byte
+	 * allocators with size classes report it through good_size(n); for
+	 * the others it is n.
+	 */
+	template <typename _Alloc, typename = void>
+	struct _alloc_good_size {
+		static size_t get(const _Alloc&, size_t n) { return n; }
+	};
+
+	template <typename _Alloc>
+	struct _alloc_good_size<
+		_Alloc, _void_t<decltype(std::declval<const _Alloc&>().good_size(size_t()))>
+	> {
+		static size_t get(const _Alloc& alloc, size_t n) { return alloc.good_size(n); }
+	};
+
+	/*
+	 * Byte allocators that can resize a block themselves, e.g. by
+	 * remapping pages, offer reallocate(p, old_bytes, new_bytes).
+	 */
+	template <typename _Alloc, typename = void>
+	struct _alloc_can_reallocate : _false_type { };
+
+	template <typename _Alloc>
+	struct _alloc_can_reallocate<
+		_Alloc,
+		_void_t<decltype(std::declval<_Alloc&>().reallocate(nullptr, size_t(), size_t()))>
+	> : _true_type { };
+
+	/*
+	 * Holds the allocator instance of a container. Containers inherit from
+	 * it privately, so stateless allocators take no space.
+	 */
 	template <typename _T, typename _Alloc>
-	class standard_alloc {
+	class standard_alloc : private _byte_allocator<_Alloc>::type {
+	protected:
+		typedef typename _byte_allocator<_Alloc>::type byte_allocator_type;
+
+	public:
+		typedef _alloc_can_reallocate<byte_allocator_type> can_reallocate;
+
+	public:
+		standard_alloc() = default;
+		explicit standard_alloc(const _Alloc& alloc) : byte_allocator_type(alloc) { }
+
 	public:
-		static _T* allocate(size_t n) {
-			return 0 == n ? nullptr : (_T*) alloc.allocate(n * sizeof (_T));
+		_T* allocate(size_t n) {
+			return 0 == n ? nullptr : (_T*) _bytes().allocate(n * sizeof (_T));
 		}
 
-		static _T* allocate() {
-			return (_T*) alloc.allocate(sizeof (_T));
+		_T* allocate() {
+			return (_T*) _bytes().allocate(sizeof (_T));
 		}
 
-		static void deallocate(_T* p, size_t n) {
+		void deallocate(_T* p, size_t n) {
 			if (0 == n) {
 				return;
 			}
-			alloc.deallocate(p, n * sizeof (_T));
+			_bytes().deallocate((char*) p, n * sizeof (_T));
 		}
 
-		static void deallocate(_T* p) {
-			alloc.deallocate( p, sizeof (_T));
+		void deallocate(_T* p) {
+			_bytes().deallocate((char*) p, sizeof (_T));
+		}
+
+		/*
+		 * resizes the block at p from old_n to new_n _T, moving its bytes
+		 * as needed. Only for allocators with reallocate and for _T that
+		 * may be moved bitwise.
+		 */
+		_T* reallocate(_T* p, size_t old_n, size_t new_n) {
+			if (0 == old_n) {
+				return allocate(new_n);
+			}
+			if (0 == new_n) {
+				deallocate(p, old_n);
+				return nullptr;
+			}
+			return (_T*) _bytes().reallocate(p, old_n * sizeof (_T), new_n * sizeof (_T));
+		}
+
+		_Alloc get_allocator() const { return _Alloc(_bytes()); }
+
+		/* number of _T that fit in the block allocate(n) really returns */
+		size_t good_size(size_t n) const {
+			return _alloc_good_size<byte_allocator_type>::get(_bytes(), n * sizeof (_T)) / sizeof (_T);
 		}
 
 	private:
-		static _Alloc alloc;
+		byte_allocator_type& _bytes() { return *this; }
+		const byte_allocator_type& _bytes() const { return *this; }
 	};
-
-	template <typename _T, typename _Alloc>
-	_Alloc standard_alloc<_T, _Alloc>::alloc = _Alloc();
 }
 
 #endif //_MEMORY_H_
@@ -0,0 +1,195 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _MEMORY_RESOURCE_H_
+#define _MEMORY_RESOURCE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace tools {
+
+	/*
+	 * Type-erased upstream for polymorphic_alloc, so containers of
+	 * different types can draw from one buffer.
+	 */
+	class memory_resource {
+	public:
+		enum { _max_align = alignof (std::max_align_t) };
+
+	public:
+		virtual ~memory_resource() = default;
+
+		void* allocate(size_t bytes, size_t alignment = _max_align) {
+			return do_allocate(bytes, alignment);
+		}
+
+		void deallocate(void* p, size_t bytes, size_t alignment = _max_align) {
+			do_deallocate(p, bytes, alignment);
+		}
+
+		bool is_equal(const memory_resource& other) const { return do_is_equal(other); }
+
+	protected:
+		virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+		virtual void do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+		virtual bool do_is_equal(const memory_resource& other) const { return this == &other; }
+	};
+
+	class _new_delete_resource : public memory_resource {
+	protected:
+		void* do_allocate(size_t bytes, size_t) override {
+			return ::operator new(bytes);
+		}
+
+		void do_deallocate(void* p, size_t, size_t) override {
+			::operator delete(p);
+		}
+
+		bool do_is_equal(const memory_resource& other) const override {
+			return nullptr != dynamic_cast<const _new_delete_resource*>(&other);
+		}
+	};
+
+	inline memory_resource* new_delete_resource() {
+		static _new_delete_resource resource;
+		return &resource;
+	}
+
+	inline memory_resource*& _default_resource() {
+		static memory_resource* resource = new_delete_resource();
+		return resource;
+	}
+
+	inline memory_resource* get_default_resource() { return _default_resource(); }
+
+	inline memory_resource* set_default_resource(memory_resource* resource) {
+		memory_resource* previous = _default_resource();
+		_default_resource() = nullptr != resource ? resource : new_delete_resource();
+		return previous;
+	}
+
+	/*
+	 * Bumps through a caller-provided buffer, then through blocks taken
+	 * from upstream. Nothing is freed before release() or destruction.
+	 */
+	class monotonic_buffer_resource : public memory_resource {
+	private:
+		struct _block {
+			_block* prev;
+			size_t  size;
+		};
+
+		memory_resource* m_upstream;
+		_block*          m_blocks;
+		char*            m_cursor;
+		char*            m_limit;
+		char*            m_initial;
+		size_t           m_initial_size;
+		size_t           m_next_size;
+
+	private:
+		static size_t _header_size() {
+			return (sizeof (_block) + _max_align - 1) & ~size_t(_max_align - 1);
+		}
+
+		static char* _align_up(char* p, size_t alignment) {
+			return (char*) (((uintptr_t) p + alignment - 1) & ~uintptr_t(alignment - 1));
+		}
+
+		void _grow(size_t bytes, size_t alignment) {
+			size_t size = _header_size() + bytes + alignment;
+			if (size < m_next_size) {
+				size = m_next_size;
+			}
+
+			_block* block = (_block*) m_upstream->allocate(size);
+			block->prev = m_blocks;
+			block->size = size;
+			m_blocks = block;
+
+			m_cursor = (char*) block + _header_size();
+			m_limit  = (char*) block + size;
+			m_next_size = size * 2;
+		}
+
+	public:
+		explicit monotonic_buffer_resource(memory_resource* upstream = get_default_resource()) :
+			m_upstream(upstream), m_blocks(nullptr),
+			m_cursor(nullptr), m_limit(nullptr),
+			m_initial(nullptr), m_initial_size(0), m_next_size(1024) { }
+
+		monotonic_buffer_resource(void*            buffer,
+		                          size_t           size,
+		                          memory_resource* upstream = get_default_resource()) :
+			m_upstream(upstream), m_blocks(nullptr),
+			m_cursor((char*) buffer), m_limit((char*) buffer + size),
+			m_initial((char*) buffer), m_initial_size(size),
+			m_next_size(0 == size ? 1024 : size * 2) { }
+
+		monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+		monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+		~monotonic_buffer_resource() override { release(); }
+
+	public:
+		void release() {
+			while (nullptr != m_blocks) {
+				_block* prev = m_blocks->prev;
+				m_upstream->deallocate(m_blocks, m_blocks->size);
+				m_blocks = prev;
+			}
+			m_cursor = m_initial;
+			m_limit  = m_initial + m_initial_size;
+		}
+
+		memory_resource* upstream_resource() const { return m_upstream; }
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			char* p = _align_up(m_cursor, alignment);
+			if (nullptr == m_cursor || m_limit < p || size_t(m_limit - p) < bytes) {
+				_grow(bytes, alignment);
+				p = _align_up(m_cursor, alignment);
+			}
+			m_cursor = p + bytes;
+			return p;
+		}
+
+		void do_deallocate(void*, size_t, size_t) override { }
+	};
+
+	/*
+	 * _Allocator for the containers forwarding to a memory_resource, the
+	 * default resource when constructed without one.
+	 */
+	class polymorphic_alloc {
+	private:
+		memory_resource* m_resource;
+
+	public:
+		polymorphic_alloc() : m_resource(get_default_resource()) { }
+		polymorphic_alloc(memory_resource* resource) : m_resource(resource) { }
+
+	public:
+		void* allocate(size_t n) { return m_resource->allocate(n); }
+		void deallocate(void* p, size_t n) { m_resource->deallocate(p, n); }
+
+		memory_resource* resource() const { return m_resource; }
+	};
+
+	inline bool operator==(const polymorphic_alloc& left,
+	                       const polymorphic_alloc& right) {
+		return left.resource() == right.resource() ||
+		       left.resource()->is_equal(*right.resource());
+	}
+
+	inline bool operator!=(const polymorphic_alloc& left,
+	                       const polymorphic_alloc& right) {
+		return !operator==(left, right);
+	}
+}
+
+#endif //_MEMORY_RESOURCE_H_
@@ -0,0 +1,450 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _MMAP_SEQUENCE_H_
+#define _MMAP_SEQUENCE_H_
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "iterator.h"
+#include "sequence.h"
+#include "type_base.h"
+
+namespace tools {
+
+	/*
+	 * first bytes of an mmap_sequence file, the elements follow at
+	 * _data_offset. size and capacity are read by other processes while
+	 * the writer updates them, so they are lock-free atomics: the writer
+	 * stores size with release once the elements are in place, readers
+	 * load it with acquire before touching them.
+	 */
+	struct _mmap_sequence_header {
+		char                  magic[8];
+		uint32_t              version;
+		uint32_t              value_size;
+		std::atomic<uint64_t> size;
+		std::atomic<uint64_t> capacity;
+	};
+
+	static_assert(2 == ATOMIC_LLONG_LOCK_FREE, "the header is shared between processes");
+	static_assert(sizeof (std::atomic<uint64_t>) == sizeof (uint64_t), "the header layout is the file format");
+
+	/*
+	 * sequence of trivially copyable values kept in a file. The file is
+	 * mapped shared, so the elements are the file contents: reopening it
+	 * costs one mmap, with nothing to parse or copy. Growing extends the
+	 * file with ftruncate and remaps it.
+	 *
+	 * mmap_sequence<const _Val> maps the file read-only: its references
+	 * and iterators are const and the modifiers do not compile. Any
+	 * number of such readers may follow one writer; refresh() picks up
+	 * what the writer appended since. Only appends are published safely,
+	 * a reader racing insert, erase or a write through operator[] may see
+	 * the elements half moved.
+	 *
+	 * The data is only as durable as the last sync().
+	 */
+	template <
+		typename _Val,
+		typename _Growth = growth::doubling
+	>
+	class mmap_sequence {
+		static_assert(_is_trivially_copyable<_Val>::value, "mmap_sequence stores raw bytes");
+		static_assert(alignof (_Val) <= 64, "elements must fit the header alignment");
+
+	public:
+		typedef typename std::remove_const<_Val>::type value_type;
+
+		typedef _Val&       reference;
+		typedef const _Val& const_reference;
+		typedef _Val*       pointer;
+		typedef const _Val* const_pointer;
+
+		typedef ptrdiff_t difference_type;
+		typedef size_t    size_type;
+
+		enum open_mode {
+			read_only,  /* the file must exist */
+			read_write, /* created when missing */
+			truncate    /* created, or emptied when present */
+		};
+
+		enum { version = 1, _data_offset = 64 };
+
+	protected:
+		typedef mmap_sequence<_Val, _Growth> self_type;
+		typedef _mmap_sequence_header        header_type;
+		typedef _Growth                      growth_type;
+
+		typedef pointer       inner_iterator;
+		typedef const_pointer const_inner_iterator;
+
+	private:
+		int          m_fd;
+		char*        m_map;
+		size_t       m_map_bytes;
+
+	private:
+		static void _throw_errno(const char* what) {
+			throw std::system_error(errno, std::generic_category(), what);
+		}
+
+		static void _magic(char (&magic)[8]) { memcpy(magic, "TOOLSSEQ", 8); }
+
+		static size_t _bytes_for(size_type capacity) { return _data_offset + capacity * sizeof (_Val); }
+
+		header_type* _header() const { return (header_type*) m_map; }
+		pointer _base() const { return (pointer) (m_map + _data_offset); }
+
+		size_type _mapped_capacity() const { return (m_map_bytes - _data_offset) / sizeof (_Val); }
+
+		/* instantiated only by the modifiers */
+		void _check_writable() const {
+			static_assert(!std::is_const<_Val>::value, "mmap_sequence<const T> is read-only");
+		}
+
+		void _map(size_t bytes) {
+			int prot = writable() ? PROT_READ | PROT_WRITE : PROT_READ;
+			void* p = mmap(nullptr, bytes, prot, MAP_SHARED, m_fd, 0);
+			if (MAP_FAILED == p) {
+				_throw_errno("mmap_sequence: mmap");
+			}
+			m_map       = (char*) p;
+			m_map_bytes = bytes;
+		}
+
+		void _remap(size_t bytes) {
+#ifdef MREMAP_MAYMOVE
+			void* p = mremap(m_map, m_map_bytes, bytes, MREMAP_MAYMOVE);
+			if (MAP_FAILED == p) {
+				_throw_errno("mmap_sequence: mremap");
+			}
+			m_map       = (char*) p;
+			m_map_bytes = bytes;
+#else
+			munmap(m_map, m_map_bytes);
+			m_map = nullptr;
+			_map(bytes);
+#endif
+		}
+
+		void _initialize_file() {
+			if (0 != ftruncate(m_fd, _data_offset)) {
+				_throw_errno("mmap_sequence: ftruncate");
+			}
+			_map(_data_offset);
+
+			header_type* header = _header();
+			_magic(header->magic);
+			header->version    = version;
+			header->value_size = sizeof (_Val);
+			header->size.store(0, std::memory_order_relaxed);
+			header->capacity.store(0, std::memory_order_relaxed);
+		}
+
+		void _validate(size_t file_bytes) const {
+			char magic[8];
+			_magic(magic);
+
+			const header_type* header = _header();
+			if (0 != memcmp(header->magic, magic, 8) || version != header->version) {
+				throw std::runtime_error("mmap_sequence: not a sequence file of this version");
+			}
+			if (sizeof (_Val) != header->value_size) {
+				throw std::runtime_error("mmap_sequence: element size does not match the file");
+			}
+			/* size first: the capacity stored before it is then visible too */
+			uint64_t size     = header->size.load(std::memory_order_acquire);
+			uint64_t capacity = header->capacity.load(std::memory_order_relaxed);
+			if (file_bytes < _bytes_for(capacity) || capacity < size) {
+				throw std::runtime_error("mmap_sequence: file is shorter than its header claims");
+			}
+		}
+
+		void _open(const char* path, open_mode mode) {
+			if (writable() == (read_only == mode)) {
+				throw std::invalid_argument("mmap_sequence: open read-only mappings as mmap_sequence<const T>");
+			}
+
+			int flags = read_only == mode ? O_RDONLY : O_RDWR | O_CREAT;
+			if (truncate == mode) {
+				flags |= O_TRUNC;
+			}
+
+			m_fd = ::open(path, flags | O_CLOEXEC, 0644);
+			if (m_fd < 0) {
+				_throw_errno("mmap_sequence: open");
+			}
+
+			struct stat st;
+			if (0 != fstat(m_fd, &st)) {
+				_throw_errno("mmap_sequence: fstat");
+			}
+
+			if (0 == st.st_size && writable()) {
+				_initialize_file();
+				return;
+			}
+			if ((size_t) st.st_size < _data_offset) {
+				throw std::runtime_error("mmap_sequence: file too short for a header");
+			}
+
+			_map((size_t) st.st_size);
+			_validate((size_t) st.st_size);
+		}
+
+		void _close() {
+			if (nullptr != m_map) {
+				munmap(m_map, m_map_bytes);
+				m_map = nullptr;
+			}
+			if (0 <= m_fd) {
+				::close(m_fd);
+				m_fd = -1;
+			}
+		}
+
+		void _extend(size_type new_capacity) {
+			size_t bytes = _bytes_for(new_capacity);
+			if (0 != ftruncate(m_fd, bytes)) {
+				_throw_errno("mmap_sequence: ftruncate");
+			}
+			_remap(bytes);
+			_header()->capacity.store(new_capacity, std::memory_order_relaxed);
+		}
+
+		void _grow_for(size_type extra) {
+			size_type needed = size() + extra;
+			if (capacity() < needed) {
+				size_type next = growth_type::next(capacity(), *this);
+				_extend(next < needed ? needed : next);
+			}
+		}
+
+		/* publishes the elements below n to readers in other processes */
+		void _set_size(size_type n) { _header()->size.store(n, std::memory_order_release); }
+
+	public:
+		explicit mmap_sequence(const char* path,
+		                       open_mode mode = std::is_const<_Val>::value ? read_only : read_write) :
+			m_fd(-1), m_map(nullptr), m_map_bytes(0) {
+			try {
+				_open(path, mode);
+			}
+			catch (...) {
+				_close();
+				throw;
+			}
+		}
+
+		mmap_sequence(const self_type&) = delete;
+		self_type& operator=(const self_type&) = delete;
+
+		mmap_sequence(self_type&& other) noexcept :
+			m_fd(other.m_fd), m_map(other.m_map), m_map_bytes(other.m_map_bytes) {
+			other.m_fd        = -1;
+			other.m_map       = nullptr;
+			other.m_map_bytes = 0;
+		}
+
+		self_type& operator=(self_type&& other) noexcept {
+			if (this != &other) {
+				_close();
+				m_fd        = other.m_fd;
+				m_map       = other.m_map;
+				m_map_bytes = other.m_map_bytes;
+				other.m_fd        = -1;
+				other.m_map       = nullptr;
+				other.m_map_bytes = 0;
+			}
+			return *this;
+		}
+
+		~mmap_sequence() { _close(); }
+
+	public:
+		const_reference operator[](size_type index) const {
+			assert(index < size());
+			return _base()[index];
+		}
+
+		reference operator[](size_type index) {
+			return const_cast<reference>(
+				((const self_type*) this)->operator[](index)
+			);
+		}
+
+	public:
+		typedef _iterator_wrapper<inner_iterator, self_type>       iterator;
+		typedef _iterator_wrapper<const_inner_iterator, self_type> const_iterator;
+
+		typedef _reverse_iterator<iterator>       reverse_iterator;
+		typedef _reverse_iterator<const_iterator> const_reverse_iterator;
+
+	public:
+		static constexpr bool writable() { return !std::is_const<_Val>::value; }
+
+		/* a reader sees what the writer appended up to its own mapping */
+		size_type size() const {
+			size_type n = _header()->size.load(std::memory_order_acquire);
+			return n < _mapped_capacity() ? n : _mapped_capacity();
+		}
+
+		bool empty() const { return 0 == size(); }
+		size_type max_size() const { return size_type(-1); }
+		size_type capacity() const { return _mapped_capacity(); }
+
+		/* whole pages, for growth::size_class_aware */
+		size_type good_size(size_type n) const {
+			size_t page = (size_t) sysconf(_SC_PAGESIZE);
+			size_t bytes = (_bytes_for(n) + page - 1) & ~(page - 1);
+			return (bytes - _data_offset) / sizeof (_Val);
+		}
+
+		reference at(size_type index) { return operator[](index); }
+		const_reference at(size_type index) const { return operator[](index); }
+
+		pointer data() { return _base(); }
+		const_pointer data() const { return _base(); }
+
+		reference front() { assert(!empty()); return _base()[0]; }
+		const_reference front() const { assert(!empty()); return _base()[0]; }
+
+		reference back() { assert(!empty()); return _base()[size() - 1]; }
+		const_reference back() const { assert(!empty()); return _base()[size() - 1]; }
+
+		void clear() { _check_writable(); _set_size(0); }
+
+		void reserve(size_type new_capacity) {
+			_check_writable();
+			if (capacity() < new_capacity) {
+				_extend(new_capacity);
+			}
+		}
+
+		void shrink_to_fit() {
+			_check_writable();
+			if (size() == capacity()) {
+				return;
+			}
+
+			size_t bytes = _bytes_for(size());
+			_remap(bytes);
+			if (0 != ftruncate(m_fd, bytes)) {
+				_throw_errno("mmap_sequence: ftruncate");
+			}
+			_header()->capacity.store(size(), std::memory_order_relaxed);
+		}
+
+		/* new elements are zero, like freshly extended file space */
+		void resize(size_type new_size) {
+			_check_writable();
+			size_type old_size = size();
+			if (old_size < new_size) {
+				_grow_for(new_size - old_size);
+				memset((void*) (_base() + old_size), 0, (new_size - old_size) * sizeof (_Val));
+			}
+			_set_size(new_size);
+		}
+
+		template <typename... _Args>
+		void emplace_back(_Args&&... args) {
+			_check_writable();
+			/* args may refer into the mapping, which can move */
+			value_type tmp{ std::forward<_Args>(args)... };
+			_grow_for(1);
+			_base()[size()] = tmp;
+			_set_size(size() + 1);
+		}
+
+		void push_back(const value_type& val) { emplace_back(val); }
+
+		void pop_back() {
+			_check_writable();
+			assert(!empty());
+			_set_size(size() - 1);
+		}
+
+		/* appends [first, first + n) with one growth step */
+		void append(const value_type* first, size_type n) {
+			_check_writable();
+			_grow_for(n);
+			if (0 != n) {
+				memcpy((void*) (_base() + size()), first, n * sizeof (_Val));
+			}
+			_set_size(size() + n);
+		}
+
+		iterator insert(const_iterator pos, const value_type& val) {
+			_check_writable();
+			difference_type offset = pos.base() - _base();
+			value_type tmp(val);
+			_grow_for(1);
+
+			pointer p = _base() + offset;
+			memmove((void*) (p + 1), p, (size() - offset) * sizeof (_Val));
+			*p = tmp;
+			_set_size(size() + 1);
+			return iterator(p);
+		}
+
+		iterator erase(const_iterator pos) {
+			_check_writable();
+			if (empty() || end() == pos) {
+				throw std::overflow_error("Invalid iterator or empty sequence.");
+			}
+
+			pointer p = _base() + (pos.base() - _base());
+			memmove((void*) p, p + 1, (_base() + size() - p - 1) * sizeof (_Val));
+			_set_size(size() - 1);
+			return iterator(p);
+		}
+
+		/* flushes the elements and header to the file */
+		void sync() {
+			if (writable() && 0 != msync(m_map, m_map_bytes, MS_SYNC)) {
+				_throw_errno("mmap_sequence: msync");
+			}
+		}
+
+		/* maps whatever the file grew to since, for readers following a writer */
+		void refresh() {
+			struct stat st;
+			if (0 != fstat(m_fd, &st)) {
+				_throw_errno("mmap_sequence: fstat");
+			}
+			if ((size_t) st.st_size != m_map_bytes) {
+				_remap((size_t) st.st_size);
+			}
+		}
+
+		iterator begin() { return iterator(_base()); }
+		const_iterator begin() const { return const_iterator(_base()); }
+
+		iterator end() { return iterator(_base() + size()); }
+		const_iterator end() const { return const_iterator(_base() + size()); }
+
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+	};
+}
+
+#endif //_MMAP_SEQUENCE_H_
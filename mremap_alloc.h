@@ -0,0 +1,129 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _MREMAP_ALLOC_H_
+#define _MREMAP_ALLOC_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace tools {
+
+	/*
+	 * Allocations of at least threshold bytes get a private anonymous
+	 * mapping of their own, smaller ones come from malloc. reallocate
+	 * grows or shrinks a mapping with mremap(MREMAP_MAYMOVE), so the
+	 * kernel moves page table entries instead of the bytes and the old
+	 * and new buffer never exist side by side. Containers use it for
+	 * element types that may be moved bitwise, e.g.
+	 * sequence<int64_t, mremap_alloc>.
+	 */
+	class mremap_alloc {
+	private:
+		size_t m_threshold;
+
+	private:
+		static size_t _page_size() {
+			static const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+			return page;
+		}
+
+		static size_t _round_up(size_t n) {
+			return (n + _page_size() - 1) & ~(_page_size() - 1);
+		}
+
+		bool _mapped(size_t n) const { return m_threshold <= n; }
+
+		static void* _map(size_t n) {
+			void* p = mmap(nullptr, _round_up(n), PROT_READ | PROT_WRITE,
+			               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (MAP_FAILED == p) {
+				throw std::bad_alloc();
+			}
+			return p;
+		}
+
+		static void* _remap(void* p, size_t old_n, size_t new_n) {
+			size_t old_length = _round_up(old_n);
+			size_t new_length = _round_up(new_n);
+			if (old_length == new_length) {
+				return p;
+			}
+
+#ifdef MREMAP_MAYMOVE
+			void* q = mremap(p, old_length, new_length, MREMAP_MAYMOVE);
+			if (MAP_FAILED == q) {
+				throw std::bad_alloc();
+			}
+			return q;
+#else
+			void* q = _map(new_n);
+			memcpy(q, p, old_length < new_length ? old_length : new_length);
+			munmap(p, old_length);
+			return q;
+#endif
+		}
+
+	public:
+		explicit mremap_alloc(size_t threshold = 1024 * 1024) : m_threshold(threshold) { }
+
+	public:
+		void* allocate(size_t n) {
+			if (_mapped(n)) {
+				return _map(n);
+			}
+
+			void* p = std::malloc(n);
+			if (nullptr == p && 0 != n) {
+				throw std::bad_alloc();
+			}
+			return p;
+		}
+
+		void deallocate(void* p, size_t n) {
+			if (nullptr == p) {
+				return;
+			}
+
+			if (_mapped(n)) {
+				munmap(p, _round_up(n));
+				return;
+			}
+			std::free(p);
+		}
+
+		void* reallocate(void* p, size_t old_n, size_t new_n) {
+			if (_mapped(old_n) && _mapped(new_n)) {
+				return _remap(p, old_n, new_n);
+			}
+
+			if (!_mapped(old_n) && !_mapped(new_n)) {
+				void* q = std::realloc(p, new_n);
+				if (nullptr == q) {
+					throw std::bad_alloc();
+				}
+				return q;
+			}
+
+			/* crossing the threshold, one copy */
+			void* q = allocate(new_n);
+			memcpy(q, p, old_n < new_n ? old_n : new_n);
+			deallocate(p, old_n);
+			return q;
+		}
+
+		size_t good_size(size_t n) const {
+			return _mapped(n) ? _round_up(n) : n;
+		}
+
+		size_t threshold() const { return m_threshold; }
+	};
+}
+
+#endif //_MREMAP_ALLOC_H_
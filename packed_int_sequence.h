@@ -0,0 +1,435 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _PACKED_INT_SEQUENCE_H_
+#define _PACKED_INT_SEQUENCE_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "algorithm.h"
+#include "sequence.h"
+
+namespace tools {
+
+	/*
+	 * Block codec of packed_int_sequence. A block holds 256 values as 4
+	 * interleaved lanes, value i in lane i % 4. Every value is stored as
+	 * its distance to the value 4 places before it (to the block's first
+	 * value for the first four), all with the width of the largest, and
+	 * word k of lane l sits at data[4 * k + l]. Decoding is then the same
+	 * shift, mask and add in each lane, which SSE2 and AVX2 do 2 and 4
+	 * lanes at a time.
+	 */
+	enum { _packed_block_values = 256, _packed_lanes = 4 };
+
+	inline uint64_t _packed_mask(unsigned width) {
+		return 64 == width ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+	}
+
+	/* field k of lane l */
+	inline uint64_t _packed_field(const uint64_t* data, unsigned width, size_t k, size_t l) {
+		size_t   bit    = k * width;
+		size_t   word   = bit / 64;
+		unsigned offset = bit % 64;
+		uint64_t value  = data[word * _packed_lanes + l] >> offset;
+		if (64 < offset + width) {
+			value |= data[(word + 1) * _packed_lanes + l] << (64 - offset);
+		}
+		return value & _packed_mask(width);
+	}
+
+	/* packs values[0, 256) after first into data, 4 * width zeroed words; returns width */
+	inline unsigned _packed_width(const uint64_t* values, uint64_t first) {
+		uint64_t bits = 0;
+		for (size_t i = 0; i < _packed_block_values; ++i) {
+			bits |= values[i] - (i < _packed_lanes ? first : values[i - _packed_lanes]);
+		}
+		return 0 == bits ? 0 : 64 - __builtin_clzll(bits);
+	}
+
+	inline void _pack_block(const uint64_t* values, uint64_t first, unsigned width, uint64_t* data) {
+		if (0 == width) {
+			return;
+		}
+		for (size_t i = 0; i < _packed_block_values; ++i) {
+			uint64_t delta  = values[i] - (i < _packed_lanes ? first : values[i - _packed_lanes]);
+			size_t   bit    = i / _packed_lanes * width;
+			size_t   word   = bit / 64;
+			unsigned offset = bit % 64;
+			size_t   l      = i % _packed_lanes;
+			data[word * _packed_lanes + l] |= delta << offset;
+			if (64 < offset + width) {
+				data[(word + 1) * _packed_lanes + l] |= delta >> (64 - offset);
+			}
+		}
+	}
+
+	inline void _unpack_block_scalar(const uint64_t* data, unsigned width, uint64_t first, uint64_t* out) {
+		uint64_t acc[_packed_lanes] = { first, first, first, first };
+		for (size_t k = 0; k < _packed_block_values / _packed_lanes; ++k) {
+			for (size_t l = 0; l < _packed_lanes; ++l) {
+				acc[l] += 0 == width ? 0 : _packed_field(data, width, k, l);
+				out[k * _packed_lanes + l] = acc[l];
+			}
+		}
+	}
+
+#ifdef _TOOLS_SIMD_X86
+
+	inline void _unpack_block_sse2(const uint64_t* data, unsigned width, uint64_t first, uint64_t* out) {
+		const __m128i mask = _mm_set1_epi64x((long long) _packed_mask(width));
+		__m128i low  = _mm_set1_epi64x((long long) first);
+		__m128i high = low;
+		for (size_t k = 0; k < _packed_block_values / _packed_lanes; ++k) {
+			size_t   bit    = k * width;
+			size_t   word   = bit / 64;
+			unsigned offset = bit % 64;
+
+			const uint64_t* p = data + word * _packed_lanes;
+			__m128i shift = _mm_cvtsi32_si128(int(offset));
+			__m128i a = _mm_srl_epi64(_mm_loadu_si128((const __m128i*) p), shift);
+			__m128i b = _mm_srl_epi64(_mm_loadu_si128((const __m128i*) (p + 2)), shift);
+			if (64 < offset + width) {
+				__m128i back = _mm_cvtsi32_si128(int(64 - offset));
+				a = _mm_or_si128(a, _mm_sll_epi64(_mm_loadu_si128((const __m128i*) (p + 4)), back));
+				b = _mm_or_si128(b, _mm_sll_epi64(_mm_loadu_si128((const __m128i*) (p + 6)), back));
+			}
+			low  = _mm_add_epi64(low, _mm_and_si128(a, mask));
+			high = _mm_add_epi64(high, _mm_and_si128(b, mask));
+			_mm_storeu_si128((__m128i*) (out + k * _packed_lanes), low);
+			_mm_storeu_si128((__m128i*) (out + k * _packed_lanes + 2), high);
+		}
+	}
+
+	__attribute__((target("avx2")))
+	inline void _unpack_block_avx2(const uint64_t* data, unsigned width, uint64_t first, uint64_t* out) {
+		const __m256i mask = _mm256_set1_epi64x((long long) _packed_mask(width));
+		__m256i acc = _mm256_set1_epi64x((long long) first);
+		for (size_t k = 0; k < _packed_block_values / _packed_lanes; ++k) {
+			size_t   bit    = k * width;
+			size_t   word   = bit / 64;
+			unsigned offset = bit % 64;
+
+			const uint64_t* p = data + word * _packed_lanes;
+			__m256i v = _mm256_srl_epi64(_mm256_loadu_si256((const __m256i*) p), _mm_cvtsi32_si128(int(offset)));
+			if (64 < offset + width) {
+				__m256i next = _mm256_loadu_si256((const __m256i*) (p + _packed_lanes));
+				v = _mm256_or_si256(v, _mm256_sll_epi64(next, _mm_cvtsi32_si128(int(64 - offset))));
+			}
+			acc = _mm256_add_epi64(acc, _mm256_and_si256(v, mask));
+			_mm256_storeu_si256((__m256i*) (out + k * _packed_lanes), acc);
+		}
+	}
+
+	inline void _unpack_block(const uint64_t* data, unsigned width, uint64_t first, uint64_t* out) {
+		if (0 == width) {
+			std::fill(out, out + _packed_block_values, first);
+			return;
+		}
+		switch (active_simd_level()) {
+			case simd_avx2: _unpack_block_avx2(data, width, first, out); break;
+			case simd_sse2: _unpack_block_sse2(data, width, first, out); break;
+			default:        _unpack_block_scalar(data, width, first, out); break;
+		}
+	}
+
+#else
+
+	inline void _unpack_block(const uint64_t* data, unsigned width, uint64_t first, uint64_t* out) {
+		_unpack_block_scalar(data, width, first, out);
+	}
+
+#endif //_TOOLS_SIMD_X86
+
+	/*
+	 * Non-decreasing uint64_t values, e.g. posting lists, compressed in
+	 * blocks of 256 (see the codec above) plus an uncompressed tail of at
+	 * most 255 values that push_back fills. A skip entry per block keeps
+	 * its first value and where its words start, so operator[] reads one
+	 * lane of one block and lower_bound decodes a single block.
+	 *
+	 * Iterators are read-only and carry a decoded block, they are cheap
+	 * to advance but not to copy.
+	 */
+	template <
+		typename _Allocator = std::allocator<uint64_t>,
+		typename _Growth    = growth::doubling
+	>
+	class packed_int_sequence {
+	public:
+		typedef uint64_t  value_type;
+		typedef uint64_t  const_reference;
+		typedef ptrdiff_t difference_type;
+		typedef size_t    size_type;
+
+	protected:
+		typedef packed_int_sequence<_Allocator, _Growth> self_type;
+
+		enum { _block_values = _packed_block_values, _lanes = _packed_lanes };
+
+		struct _block {
+			uint64_t first;
+			uint64_t offset; /* into m_words */
+			unsigned width;
+		};
+
+		typedef sequence<uint64_t, _Allocator, _Growth> word_sequence;
+		typedef sequence<_block, _Allocator, _Growth>   block_sequence;
+
+	private:
+		word_sequence  m_words;
+		block_sequence m_blocks;
+		size_type      m_tail_size;
+		uint64_t       m_tail[_block_values];
+
+	protected:
+		void _flush_tail() {
+			_block block;
+			block.first  = m_tail[0];
+			block.offset = m_words.size();
+			block.width  = _packed_width(m_tail, block.first);
+
+			m_blocks.push_back(block);
+			try {
+				/* insert grows by the policy, resize would reallocate to the exact size */
+				m_words.insert(m_words.end(), size_type(_lanes * block.width), uint64_t(0));
+			}
+			catch (...) {
+				m_blocks.pop_back();
+				throw;
+			}
+			if (0 != block.width) {
+				_pack_block(m_tail, block.first, block.width, &m_words[block.offset]);
+			}
+			m_tail_size = 0;
+		}
+
+		void _decode(size_type b, uint64_t* out) const {
+			const _block& block = m_blocks[b];
+			_unpack_block(m_words.empty() ? nullptr : &m_words[0] + block.offset, block.width, block.first, out);
+		}
+
+		/* first index in [0, n) of out not less than value, n when none */
+		static size_type _search(const uint64_t* out, size_type n, uint64_t value) {
+			return std::lower_bound(out, out + n, value) - out;
+		}
+
+	public:
+		class const_iterator {
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef uint64_t                  value_type;
+			typedef uint64_t                  reference;
+			typedef const uint64_t*           pointer;
+			typedef ptrdiff_t                 difference_type;
+
+		private:
+			const self_type*  m_owner;
+			size_type         m_index;
+			mutable size_type m_block; /* decoded into m_values, -1 for none */
+			mutable uint64_t  m_values[_block_values];
+
+		public:
+			const_iterator() : m_owner(nullptr), m_index(0), m_block(size_type(-1)) { }
+			const_iterator(const self_type* owner, size_type index) :
+				m_owner(owner), m_index(index), m_block(size_type(-1)) { }
+
+		public:
+			size_type index() const { return m_index; }
+
+			reference operator*() const {
+				size_type b = m_index / _block_values;
+				if (m_owner->m_blocks.size() == b) {
+					return m_owner->m_tail[m_index % _block_values];
+				}
+				if (b != m_block) {
+					m_owner->_decode(b, m_values);
+					m_block = b;
+				}
+				return m_values[m_index % _block_values];
+			}
+
+			const_iterator& operator++() { ++m_index; return *this; }
+			const_iterator operator++(int) { const_iterator tmp = *this; ++m_index; return tmp; }
+
+			bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+			bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+		};
+
+		typedef const_iterator iterator;
+
+	public:
+		packed_int_sequence() : m_tail_size(0) { }
+
+		explicit packed_int_sequence(const _Allocator& alloc) :
+			m_words(alloc), m_blocks(alloc), m_tail_size(0) { }
+
+		template <typename _InputIterator>
+		packed_int_sequence(_InputIterator first, _InputIterator last, const _Allocator& alloc = _Allocator()) :
+			m_words(alloc), m_blocks(alloc), m_tail_size(0) {
+			for (; first != last; ++first) {
+				push_back(*first);
+			}
+		}
+
+		packed_int_sequence(const self_type& other) :
+			m_words(other.m_words), m_blocks(other.m_blocks), m_tail_size(other.m_tail_size) {
+			std::copy(other.m_tail, other.m_tail + m_tail_size, m_tail);
+		}
+
+		packed_int_sequence(self_type&& other) noexcept :
+			m_words(std::move(other.m_words)),
+			m_blocks(std::move(other.m_blocks)),
+			m_tail_size(other.m_tail_size) {
+			std::copy(other.m_tail, other.m_tail + m_tail_size, m_tail);
+			other.m_tail_size = 0;
+		}
+
+		self_type& operator=(const self_type& other) {
+			if (this != &other) {
+				self_type tmp(other);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		self_type& operator=(self_type&& other) noexcept {
+			if (this != &other) {
+				self_type tmp(std::move(other));
+				swap(tmp);
+			}
+			return *this;
+		}
+
+	public:
+		/* value must not be less than back() */
+		void push_back(value_type value) {
+			if (!empty() && value < back()) {
+				throw std::invalid_argument("packed_int_sequence values must not decrease");
+			}
+			m_tail[m_tail_size++] = value;
+			if (_block_values == m_tail_size) {
+				try {
+					_flush_tail();
+				}
+				catch (...) {
+					--m_tail_size;
+					throw;
+				}
+			}
+		}
+
+		value_type operator[](size_type index) const {
+			assert(index < size());
+			size_type b = index / _block_values;
+			size_type i = index % _block_values;
+			if (m_blocks.size() == b) {
+				return m_tail[i];
+			}
+
+			const _block& block = m_blocks[b];
+			value_type value = block.first;
+			if (0 != block.width) {
+				const uint64_t* data = &m_words[0] + block.offset;
+				for (size_type k = 0; k <= i / _lanes; ++k) {
+					value += _packed_field(data, block.width, k, i % _lanes);
+				}
+			}
+			return value;
+		}
+
+		value_type at(size_type index) const {
+			if (size() <= index) {
+				throw std::out_of_range("packed_int_sequence index out of range");
+			}
+			return operator[](index);
+		}
+
+		value_type front() const { assert(!empty()); return m_blocks.empty() ? m_tail[0] : m_blocks[0].first; }
+		value_type back() const { assert(!empty()); return 0 != m_tail_size ? m_tail[m_tail_size - 1] : operator[](size() - 1); }
+
+		/* index of the first value not less than value, size() when none */
+		size_type lower_bound(value_type value) const {
+			/* blocks before b start below value, so the answer is in block b - 1 or starts block b */
+			size_type b = std::lower_bound(m_blocks.begin(), m_blocks.end(), value,
+			                               [](const _block& block, value_type v) { return block.first < v; })
+			              - m_blocks.begin();
+			if (0 != b) {
+				uint64_t  values[_block_values];
+				_decode(b - 1, values);
+				size_type i = _search(values, _block_values, value);
+				if (_block_values != i) {
+					return (b - 1) * _block_values + i;
+				}
+			}
+			if (b != m_blocks.size()) {
+				return b * _block_values;
+			}
+			return b * _block_values + _search(m_tail, m_tail_size, value);
+		}
+
+		bool contains(value_type value) const {
+			size_type i = lower_bound(value);
+			return i != size() && operator[](i) == value;
+		}
+
+	public:
+		_Allocator get_allocator() const { return m_words.get_allocator(); }
+
+		bool empty() const { return 0 == size(); }
+		size_type size() const { return m_blocks.size() * _block_values + m_tail_size; }
+		size_type max_size() const { return size_type(-1); }
+
+		/* bytes held for the values, skip index included */
+		size_type memory_usage() const {
+			return sizeof (self_type) +
+			       m_words.capacity() * sizeof (uint64_t) +
+			       m_blocks.capacity() * sizeof (_block);
+		}
+
+		void shrink_to_fit() {
+			m_words.shrink_to_fit();
+			m_blocks.shrink_to_fit();
+		}
+
+		void clear() {
+			m_words.clear();
+			m_blocks.clear();
+			m_tail_size = 0;
+		}
+
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, size()); }
+
+		void swap(self_type& other) {
+			m_words.swap(other.m_words);
+			m_blocks.swap(other.m_blocks);
+			/* only the live part of each tail is read, the rest is uninitialized */
+			size_type common = std::min(m_tail_size, other.m_tail_size);
+			std::swap_ranges(m_tail, m_tail + common, other.m_tail);
+			if (common < m_tail_size) {
+				std::copy(m_tail + common, m_tail + m_tail_size, other.m_tail + common);
+			}
+			else {
+				std::copy(other.m_tail + common, other.m_tail + other.m_tail_size, m_tail + common);
+			}
+			std::swap(m_tail_size, other.m_tail_size);
+		}
+	};
+
+	template <typename _Allocator, typename _Growth>
+	inline void swap(packed_int_sequence<_Allocator, _Growth>& left,
+	                 packed_int_sequence<_Allocator, _Growth>& right) {
+		left.swap(right);
+	}
+}
+
+#endif //_PACKED_INT_SEQUENCE_H_
@@ -0,0 +1,305 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "functor.h"
+#include "iterator.h"
+#include "memory.h"
+#include "sequence.h"
+#include "thread_pool.h"
+
+namespace tools {
+
+	/*
+	 * Parallel algorithms over random access ranges, sequence iterators
+	 * and raw pointers alike. The range is cut into chunks of at least
+	 * grain elements, a few per thread, which run on a fork_join_pool.
+	 * Every overload has a twin taking a parallel::policy first to pick
+	 * the pool and the grain.
+	 */
+	namespace parallel {
+
+		struct policy {
+			fork_join_pool* pool;
+			size_t          grain;
+
+			explicit policy(size_t          grain = 4096,
+			                fork_join_pool& pool  = fork_join_pool::instance()) :
+				pool(&pool), grain(0 == grain ? 1 : grain) { }
+		};
+
+		/* splits n elements into chunks, chunk i is [begin(i), begin(i + 1)) */
+		class _chunking {
+		private:
+			size_t m_length;
+			size_t m_chunks;
+
+		public:
+			_chunking(const policy& exec, size_t length) : m_length(length) {
+				size_t by_grain = length / exec.grain;
+				size_t by_pool  = exec.pool->concurrency() * 4;
+				m_chunks = std::max<size_t>(1, std::min(by_grain, by_pool));
+			}
+
+			size_t size() const { return m_chunks; }
+			size_t begin(size_t i) const { return m_length / m_chunks * i + std::min(i, m_length % m_chunks); }
+		};
+
+		template <typename _RandomAccessIterator, typename _Function>
+		void for_each(const policy&         exec ,
+		              _RandomAccessIterator first,
+		              _RandomAccessIterator last ,
+		              _Function             fn   ) {
+			_chunking chunks(exec, last - first);
+			exec.pool->run(chunks.size(), [&](size_t i) {
+				std::for_each(first + chunks.begin(i), first + chunks.begin(i + 1), fn);
+			});
+		}
+
+		template <typename _RandomAccessIterator, typename _Function>
+		void for_each(_RandomAccessIterator first, _RandomAccessIterator last, _Function fn) {
+			for_each(policy(), first, last, fn);
+		}
+
+		template <typename _RandomAccessIterator, typename _OutputIterator, typename _Function>
+		_OutputIterator transform(const policy&         exec   ,
+		                          _RandomAccessIterator first  ,
+		                          _RandomAccessIterator last   ,
+		                          _OutputIterator       d_first,
+		                          _Function             fn     ) {
+			_chunking chunks(exec, last - first);
+			exec.pool->run(chunks.size(), [&](size_t i) {
+				std::transform(first + chunks.begin(i), first + chunks.begin(i + 1),
+				               d_first + chunks.begin(i), fn);
+			});
+			return d_first + (last - first);
+		}
+
+		template <typename _RandomAccessIterator, typename _OutputIterator, typename _Function>
+		_OutputIterator transform(_RandomAccessIterator first  ,
+		                          _RandomAccessIterator last   ,
+		                          _OutputIterator       d_first,
+		                          _Function             fn     ) {
+			return transform(policy(), first, last, d_first, fn);
+		}
+
+		/* op must be associative, chunks are folded in order */
+		template <typename _RandomAccessIterator, typename _T, typename _BinaryOp>
+		_T reduce(const policy&         exec ,
+		          _RandomAccessIterator first,
+		          _RandomAccessIterator last ,
+		          _T                    init ,
+		          _BinaryOp             op   ) {
+			_chunking chunks(exec, last - first);
+			if (first == last) {
+				return init;
+			}
+
+			sequence<_T> partials(chunks.size());
+			partials.resize(chunks.size());
+			exec.pool->run(chunks.size(), [&](size_t i) {
+				_RandomAccessIterator p = first + chunks.begin(i);
+				_RandomAccessIterator q = first + chunks.begin(i + 1);
+				_T acc = *p;
+				for (++p; p != q; ++p) {
+					acc = op(acc, *p);
+				}
+				partials[i] = acc;
+			});
+
+			for (size_t i = 0; i < partials.size(); ++i) {
+				init = op(init, partials[i]);
+			}
+			return init;
+		}
+
+		template <typename _RandomAccessIterator, typename _T>
+		_T reduce(_RandomAccessIterator first, _RandomAccessIterator last, _T init) {
+			return reduce(policy(), first, last, init, plus<_T>());
+		}
+
+		template <typename _RandomAccessIterator, typename _T, typename _BinaryOp>
+		_T reduce(_RandomAccessIterator first, _RandomAccessIterator last, _T init, _BinaryOp op) {
+			return reduce(policy(), first, last, init, op);
+		}
+
+		/*
+		 * d_first[i] = first[0] op ... op first[i]. Chunks are summed, the
+		 * sums are scanned serially, then every chunk is scanned from its
+		 * offset. d_first may be first.
+		 */
+		template <typename _RandomAccessIterator, typename _OutputIterator, typename _BinaryOp>
+		_OutputIterator inclusive_scan(const policy&         exec   ,
+		                               _RandomAccessIterator first  ,
+		                               _RandomAccessIterator last   ,
+		                               _OutputIterator       d_first,
+		                               _BinaryOp             op     ) {
+			typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+
+			_chunking chunks(exec, last - first);
+			if (first == last) {
+				return d_first;
+			}
+
+			sequence<value_type> sums(chunks.size());
+			sums.resize(chunks.size());
+			exec.pool->run(chunks.size() - 1, [&](size_t i) {
+				_RandomAccessIterator p = first + chunks.begin(i);
+				_RandomAccessIterator q = first + chunks.begin(i + 1);
+				value_type acc = *p;
+				for (++p; p != q; ++p) {
+					acc = op(acc, *p);
+				}
+				sums[i] = acc;
+			});
+
+			for (size_t i = 1; i + 1 < chunks.size(); ++i) {
+				sums[i] = op(sums[i - 1], sums[i]);
+			}
+
+			exec.pool->run(chunks.size(), [&](size_t i) {
+				_RandomAccessIterator p = first + chunks.begin(i);
+				_RandomAccessIterator q = first + chunks.begin(i + 1);
+				_OutputIterator       d = d_first + chunks.begin(i);
+				value_type acc = 0 == i ? *p : op(sums[i - 1], *p);
+				*d = acc;
+				for (++p, ++d; p != q; ++p, ++d) {
+					acc = op(acc, *p);
+					*d = acc;
+				}
+			});
+
+			return d_first + (last - first);
+		}
+
+		template <typename _RandomAccessIterator, typename _OutputIterator>
+		_OutputIterator inclusive_scan(_RandomAccessIterator first  ,
+		                               _RandomAccessIterator last   ,
+		                               _OutputIterator       d_first) {
+			typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+			return inclusive_scan(policy(), first, last, d_first, plus<value_type>());
+		}
+
+		template <typename _RandomAccessIterator, typename _OutputIterator, typename _BinaryOp>
+		_OutputIterator inclusive_scan(_RandomAccessIterator first  ,
+		                               _RandomAccessIterator last   ,
+		                               _OutputIterator       d_first,
+		                               _BinaryOp             op     ) {
+			return inclusive_scan(policy(), first, last, d_first, op);
+		}
+
+		/* chunks are sorted in parallel, then merged pairwise, each round in parallel */
+		template <typename _RandomAccessIterator, typename _Comparator>
+		void sort(const policy&         exec ,
+		          _RandomAccessIterator first,
+		          _RandomAccessIterator last ,
+		          _Comparator           comp ) {
+			_chunking chunks(exec, last - first);
+			exec.pool->run(chunks.size(), [&](size_t i) {
+				std::sort(first + chunks.begin(i), first + chunks.begin(i + 1), comp);
+			});
+
+			for (size_t width = 1; width < chunks.size(); width *= 2) {
+				size_t pairs = (chunks.size() + 2 * width - 1) / (2 * width);
+				exec.pool->run(pairs, [&](size_t k) {
+					size_t left  = 2 * width * k;
+					size_t mid   = std::min(left + width, chunks.size());
+					size_t right = std::min(left + 2 * width, chunks.size());
+					if (mid < right) {
+						std::inplace_merge(first + chunks.begin(left),
+						                   first + chunks.begin(mid),
+						                   first + chunks.begin(right), comp);
+					}
+				});
+			}
+		}
+
+		template <typename _RandomAccessIterator>
+		void sort(_RandomAccessIterator first, _RandomAccessIterator last) {
+			typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+			sort(policy(), first, last, less<value_type>());
+		}
+
+		template <typename _RandomAccessIterator, typename _Comparator>
+		void sort(_RandomAccessIterator first, _RandomAccessIterator last, _Comparator comp) {
+			sort(policy(), first, last, comp);
+		}
+
+		/*
+		 * Stable partition, returns the first element failing pred. pred
+		 * is called once per element; the elements pass through a buffer,
+		 * so moving them must not throw.
+		 */
+		template <typename _RandomAccessIterator, typename _Predicate>
+		_RandomAccessIterator partition(const policy&         exec ,
+		                                _RandomAccessIterator first,
+		                                _RandomAccessIterator last ,
+		                                _Predicate            pred ) {
+			typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+			static_assert(std::is_nothrow_move_constructible<value_type>::value &&
+			              std::is_nothrow_move_assignable<value_type>::value,
+			              "parallel::partition needs non-throwing moves");
+
+			const size_t length = last - first;
+			_chunking chunks(exec, length);
+
+			sequence<unsigned char> flags(length);
+			flags.resize(length);
+			sequence<size_t> selected(chunks.size());
+			selected.resize(chunks.size());
+
+			exec.pool->run(chunks.size(), [&](size_t i) {
+				size_t n = 0;
+				for (size_t j = chunks.begin(i); j != chunks.begin(i + 1); ++j) {
+					flags[j] = pred(first[j]) ? 1 : 0;
+					n += flags[j];
+				}
+				selected[i] = n;
+			});
+
+			size_t total = 0;
+			for (size_t i = 0; i < selected.size(); ++i) {
+				size_t n = selected[i];
+				selected[i] = total;
+				total += n;
+			}
+
+			value_type* buffer = (value_type*) ::operator new(length * sizeof (value_type));
+			exec.pool->run(chunks.size(), [&](size_t i) {
+				size_t yes = selected[i];
+				size_t no  = total + chunks.begin(i) - selected[i];
+				for (size_t j = chunks.begin(i); j != chunks.begin(i + 1); ++j) {
+					construct(buffer + (flags[j] ? yes++ : no++), std::move(first[j]));
+				}
+			});
+
+			exec.pool->run(chunks.size(), [&](size_t i) {
+				for (size_t j = chunks.begin(i); j != chunks.begin(i + 1); ++j) {
+					first[j] = std::move(buffer[j]);
+					destroy(buffer + j);
+				}
+			});
+			::operator delete(buffer);
+
+			return first + total;
+		}
+
+		template <typename _RandomAccessIterator, typename _Predicate>
+		_RandomAccessIterator partition(_RandomAccessIterator first,
+		                                _RandomAccessIterator last ,
+		                                _Predicate            pred ) {
+			return partition(policy(), first, last, pred);
+		}
+	}
+}
+
+#endif //_PARALLEL_H_
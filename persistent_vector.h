@@ -0,0 +1,735 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _PERSISTENT_VECTOR_H_
+#define _PERSISTENT_VECTOR_H_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "memory.h"
+
+namespace tools {
+
+	/*
+	 * Radix balanced trie of 32-way nodes with the last, partly filled
+	 * leaf kept aside as the tail (Bagwell, Hickey). Nodes are reference
+	 * counted and shared between versions: copying a vector is O(1) and
+	 * an update copies the O(log32 n) nodes on its path, most of the time
+	 * just the tail. Nodes may only be edited in place by the transient
+	 * that created them, see transient_vector.
+	 *
+	 * Versions may be read and dropped from any thread; the counts are
+	 * atomic. A transient is for one thread.
+	 */
+	template <typename _Val, typename _Allocator>
+	class _persistent_vector_base : private standard_alloc<char, _Allocator> {
+	public:
+		typedef _Val        value_type;
+		typedef _Val&       reference;
+		typedef const _Val& const_reference;
+		typedef _Val*       pointer;
+		typedef const _Val* const_pointer;
+
+		typedef ptrdiff_t difference_type;
+		typedef size_t    size_type;
+
+		enum { _bits = 5, _width = 1 << _bits, _mask = _width - 1 };
+
+	protected:
+		typedef _persistent_vector_base<_Val, _Allocator> self_type;
+		typedef standard_alloc<char, _Allocator>         allocator_type;
+
+		struct _node {
+			std::atomic<size_t> refs;
+			uint64_t            owner; /* transient allowed to edit in place, 0 for none */
+		};
+
+		struct _inner : _node {
+			_node* children[_width];
+		};
+
+		struct _leaf : _node {
+			size_t count;
+			typename std::aligned_storage<sizeof (_Val), alignof (_Val)>::type values[_width];
+
+			_Val* data() { return (_Val*) values; }
+		};
+
+	protected:
+		_inner*   m_root;  /* nullptr while every element sits in the tail */
+		_leaf*    m_tail;  /* nullptr when empty */
+		size_type m_size;
+		size_type m_shift; /* level of m_root, leaves are level 0 */
+
+	protected:
+		static uint64_t _new_owner() {
+			static std::atomic<uint64_t> counter(0);
+			return ++counter;
+		}
+
+		static bool _editable(const _node* node, uint64_t owner) {
+			return 0 != owner && node->owner == owner;
+		}
+
+		static void _retain(_node* node) {
+			if (nullptr != node) {
+				node->refs.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		/* drops a reference to node, a subtree of the given level */
+		void _release(_node* node, size_type level) {
+			if (nullptr == node || 1 != node->refs.fetch_sub(1, std::memory_order_acq_rel)) {
+				return;
+			}
+
+			if (0 == level) {
+				_leaf* leaf = (_leaf*) node;
+				destroy(leaf->data(), leaf->data() + leaf->count);
+				leaf->~_leaf();
+				allocator_type::deallocate((char*) leaf, sizeof (_leaf));
+				return;
+			}
+
+			_inner* inner = (_inner*) node;
+			for (size_type i = 0; i < _width; ++i) {
+				_release(inner->children[i], level - _bits);
+			}
+			inner->~_inner();
+			allocator_type::deallocate((char*) inner, sizeof (_inner));
+		}
+
+		_inner* _new_inner(uint64_t owner) {
+			char* p = allocator_type::allocate(sizeof (_inner));
+			if (nullptr == p) {
+				throw std::bad_alloc();
+			}
+			_inner* inner = new (p) _inner;
+			inner->refs.store(1, std::memory_order_relaxed);
+			inner->owner = owner;
+			for (size_type i = 0; i < _width; ++i) {
+				inner->children[i] = nullptr;
+			}
+			return inner;
+		}
+
+		_leaf* _new_leaf(uint64_t owner) {
+			char* p = allocator_type::allocate(sizeof (_leaf));
+			if (nullptr == p) {
+				throw std::bad_alloc();
+			}
+			_leaf* leaf = new (p) _leaf;
+			leaf->refs.store(1, std::memory_order_relaxed);
+			leaf->owner = owner;
+			leaf->count = 0;
+			return leaf;
+		}
+
+		_inner* _copy_inner(const _inner* node, uint64_t owner) {
+			_inner* copy = _new_inner(owner);
+			for (size_type i = 0; i < _width; ++i) {
+				copy->children[i] = node->children[i];
+				_retain(copy->children[i]);
+			}
+			return copy;
+		}
+
+		/* copies the first n values of leaf */
+		_leaf* _copy_leaf(_leaf* leaf, size_type n, uint64_t owner) {
+			_leaf* copy = _new_leaf(owner);
+			try {
+				tools::uninitialized_copy((const _Val*) leaf->data(), (const _Val*) leaf->data() + n, copy->data());
+			}
+			catch (...) {
+				_release(copy, 0);
+				throw;
+			}
+			copy->count = n;
+			return copy;
+		}
+
+		size_type _tail_offset() const {
+			return m_size < _width ? 0 : ((m_size - 1) >> _bits) << _bits;
+		}
+
+		_leaf* _leaf_for(size_type index) const {
+			if (_tail_offset() <= index) {
+				return m_tail;
+			}
+
+			_node* node = m_root;
+			for (size_type level = m_shift; 0 < level; level -= _bits) {
+				node = ((_inner*) node)->children[(index >> level) & _mask];
+			}
+			return (_leaf*) node;
+		}
+
+		/* a chain of fresh inner nodes from level down to leaf */
+		_node* _new_path(size_type level, _leaf* leaf, uint64_t owner) {
+			if (0 == level) {
+				return leaf;
+			}
+
+			_inner* inner = _new_inner(owner);
+			try {
+				inner->children[0] = _new_path(level - _bits, leaf, owner);
+			}
+			catch (...) {
+				_release(inner, level);
+				throw;
+			}
+			return inner;
+		}
+
+		/*
+		 * Helpers below return node itself when it was edited in place, or
+		 * a new node for the caller to swap in; they never release node.
+		 */
+
+		_inner* _own(_inner* node, uint64_t owner) {
+			return _editable(node, owner) ? node : _copy_inner(node, owner);
+		}
+
+		/* puts child into slot index of node, dropping what was there */
+		void _replace_child(_inner* node, size_type index, _node* child, size_type child_level) {
+			_node* old = node->children[index];
+			if (old != child) {
+				node->children[index] = child;
+				_release(old, child_level);
+			}
+		}
+
+		/* hangs the full tail below node, leaf holds a reference of its own */
+		_inner* _push_tail(size_type level, _inner* node, _leaf* leaf, uint64_t owner) {
+			_inner* result = _own(node, owner);
+			size_type index = ((m_size - 1) >> level) & _mask;
+
+			_node* child = nullptr;
+			try {
+				if (_bits == level) {
+					child = leaf;
+				}
+				else if (nullptr != result->children[index]) {
+					child = _push_tail(level - _bits, (_inner*) result->children[index], leaf, owner);
+				}
+				else {
+					child = _new_path(level - _bits, leaf, owner);
+				}
+			}
+			catch (...) {
+				if (result != node) {
+					_release(result, level);
+				}
+				throw;
+			}
+
+			_replace_child(result, index, child, level - _bits);
+			return result;
+		}
+
+		/* drops the last leaf below node, nullptr when node ends up empty */
+		_inner* _pop_tail(size_type level, _inner* node, uint64_t owner) {
+			size_type index = ((m_size - 2) >> level) & _mask;
+
+			if (_bits < level) {
+				_inner* child = (_inner*) node->children[index];
+				_inner* new_child = _pop_tail(level - _bits, child, owner);
+				if (nullptr == new_child && 0 == index) {
+					return nullptr;
+				}
+
+				_inner* result = nullptr;
+				try {
+					result = _own(node, owner);
+				}
+				catch (...) {
+					if (new_child != child) {
+						_release(new_child, level - _bits);
+					}
+					throw;
+				}
+				_replace_child(result, index, new_child, level - _bits);
+				return result;
+			}
+
+			if (0 == index) {
+				return nullptr;
+			}
+
+			_inner* result = _own(node, owner);
+			_replace_child(result, index, nullptr, 0);
+			return result;
+		}
+
+		template <typename _Arg>
+		_node* _assign(size_type level, _node* node, size_type index, _Arg&& val, uint64_t owner) {
+			if (0 == level) {
+				_leaf* leaf = (_leaf*) node;
+				_leaf* result = _editable(leaf, owner) ? leaf : _copy_leaf(leaf, leaf->count, owner);
+				try {
+					result->data()[index & _mask] = std::forward<_Arg>(val);
+				}
+				catch (...) {
+					if (result != leaf) {
+						_release(result, 0);
+					}
+					throw;
+				}
+				return result;
+			}
+
+			_inner* inner = (_inner*) node;
+			_inner* result = _own(inner, owner);
+			size_type slot = (index >> level) & _mask;
+			_node* child = nullptr;
+			try {
+				child = _assign(level - _bits, result->children[slot], index, std::forward<_Arg>(val), owner);
+			}
+			catch (...) {
+				if (result != inner) {
+					_release(result, level);
+				}
+				throw;
+			}
+			_replace_child(result, slot, child, level - _bits);
+			return result;
+		}
+
+	protected:
+		template <typename _Arg>
+		void _push_back(_Arg&& val, uint64_t owner) {
+			size_type tail_count = m_size - _tail_offset();
+
+			if (nullptr != m_tail && tail_count < _width) {
+				if (_editable(m_tail, owner)) {
+					construct(m_tail->data() + tail_count, std::forward<_Arg>(val));
+					++m_tail->count;
+				}
+				else {
+					_leaf* tail = _copy_leaf(m_tail, tail_count, owner);
+					try {
+						construct(tail->data() + tail_count, std::forward<_Arg>(val));
+					}
+					catch (...) {
+						_release(tail, 0);
+						throw;
+					}
+					++tail->count;
+					_release(m_tail, 0);
+					m_tail = tail;
+				}
+				++m_size;
+				return;
+			}
+
+			/* the new tail is built first, val may live in the old one */
+			_leaf* tail = _new_leaf(owner);
+			try {
+				construct(tail->data(), std::forward<_Arg>(val));
+			}
+			catch (...) {
+				_release(tail, 0);
+				throw;
+			}
+			tail->count = 1;
+
+			if (nullptr == m_tail) {
+				m_tail = tail;
+				++m_size;
+				return;
+			}
+
+			/* the full tail moves into the trie, which takes a reference of its own */
+			_inner*   root  = nullptr;
+			size_type shift = m_shift;
+			_retain(m_tail);
+			try {
+				if (nullptr == m_root) {
+					root = _new_inner(owner);
+					root->children[0] = m_tail;
+					shift = _bits;
+				}
+				else if ((m_size >> _bits) > (size_type(1) << m_shift)) {
+					root = _new_inner(owner);
+					root->children[0] = m_root;
+					_retain(m_root);
+					try {
+						root->children[1] = _new_path(m_shift, m_tail, owner);
+					}
+					catch (...) {
+						_release(root, m_shift + _bits);
+						throw;
+					}
+					shift = m_shift + _bits;
+				}
+				else {
+					root = _push_tail(m_shift, m_root, m_tail, owner);
+				}
+			}
+			catch (...) {
+				_release(m_tail, 0);
+				_release(tail, 0);
+				throw;
+			}
+
+			if (root != m_root) {
+				_release(m_root, m_shift);
+			}
+			_release(m_tail, 0);
+
+			m_root  = root;
+			m_shift = shift;
+			m_tail  = tail;
+			++m_size;
+		}
+
+		void _pop_back(uint64_t owner) {
+			if (0 == m_size) {
+				throw std::out_of_range("pop_back on an empty persistent vector");
+			}
+
+			if (1 == m_size) {
+				_release(m_tail, 0);
+				m_tail = nullptr;
+				m_size = 0;
+				return;
+			}
+
+			size_type tail_count = m_size - _tail_offset();
+			if (1 < tail_count) {
+				if (_editable(m_tail, owner)) {
+					destroy(m_tail->data() + tail_count - 1);
+					--m_tail->count;
+				}
+				else {
+					_leaf* tail = _copy_leaf(m_tail, tail_count - 1, owner);
+					_release(m_tail, 0);
+					m_tail = tail;
+				}
+				--m_size;
+				return;
+			}
+
+			/* the last leaf of the trie becomes the tail */
+			_leaf* tail = _leaf_for(m_size - 2);
+			_retain(tail);
+
+			_inner* root = nullptr;
+			try {
+				root = _pop_tail(m_shift, m_root, owner);
+			}
+			catch (...) {
+				_release(tail, 0);
+				throw;
+			}
+
+			size_type shift = m_shift;
+			if (nullptr != root && _bits < shift && nullptr == root->children[1]) {
+				_inner* only = (_inner*) root->children[0];
+				_retain(only);
+				if (root != m_root) {
+					_release(root, shift);
+				}
+				root = only;
+				shift -= _bits;
+			}
+
+			if (root != m_root) {
+				_release(m_root, m_shift);
+			}
+			m_root  = root;
+			m_shift = nullptr == root ? 0 : shift;
+
+			_release(m_tail, 0);
+			m_tail = tail;
+			--m_size;
+		}
+
+		template <typename _Arg>
+		void _set(size_type index, _Arg&& val, uint64_t owner) {
+			if (m_size <= index) {
+				throw std::out_of_range("persistent vector index out of range");
+			}
+
+			if (_tail_offset() <= index) {
+				_node* tail = _assign(0, m_tail, index, std::forward<_Arg>(val), owner);
+				if (tail != m_tail) {
+					_release(m_tail, 0);
+					m_tail = (_leaf*) tail;
+				}
+				return;
+			}
+
+			_node* root = _assign(m_shift, m_root, index, std::forward<_Arg>(val), owner);
+			if (root != m_root) {
+				_release(m_root, m_shift);
+				m_root = (_inner*) root;
+			}
+		}
+
+		void _swap(self_type& other) {
+			std::swap((allocator_type&) *this, (allocator_type&) other);
+			std::swap(m_root, other.m_root);
+			std::swap(m_tail, other.m_tail);
+			std::swap(m_size, other.m_size);
+			std::swap(m_shift, other.m_shift);
+		}
+
+	public:
+		/* random access over one version, remembers the leaf it is in */
+		class const_iterator {
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef _Val                            value_type;
+			typedef const _Val&                     reference;
+			typedef const _Val*                     pointer;
+			typedef ptrdiff_t                       difference_type;
+
+		private:
+			const self_type*    m_owner;
+			size_type           m_index;
+			mutable const _Val* m_leaf;
+			mutable size_type   m_leaf_start;
+
+		public:
+			const_iterator() : m_owner(nullptr), m_index(0), m_leaf(nullptr), m_leaf_start(0) { }
+			const_iterator(const self_type* owner, size_type index) :
+				m_owner(owner), m_index(index), m_leaf(nullptr), m_leaf_start(0) { }
+
+		public:
+			reference operator*() const {
+				if (nullptr == m_leaf || m_index - m_leaf_start >= size_type(_width)) {
+					m_leaf_start = m_index & ~size_type(_mask);
+					m_leaf = m_owner->_leaf_for(m_index)->data();
+				}
+				return m_leaf[m_index - m_leaf_start];
+			}
+
+			pointer operator->() const { return &operator*(); }
+			reference operator[](difference_type n) const { return *(*this + n); }
+
+			const_iterator& operator++() { ++m_index; return *this; }
+			const_iterator operator++(int) { const_iterator tmp = *this; ++m_index; return tmp; }
+
+			const_iterator& operator--() { --m_index; return *this; }
+			const_iterator operator--(int) { const_iterator tmp = *this; --m_index; return tmp; }
+
+			const_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+			const_iterator operator+(difference_type n) const { const_iterator tmp = *this; return tmp += n; }
+
+			const_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+			const_iterator operator-(difference_type n) const { const_iterator tmp = *this; return tmp -= n; }
+
+			difference_type operator-(const const_iterator& other) const {
+				return difference_type(m_index) - difference_type(other.m_index);
+			}
+
+			bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+			bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+			bool operator<(const const_iterator& other) const { return m_index < other.m_index; }
+			bool operator>(const const_iterator& other) const { return m_index > other.m_index; }
+			bool operator<=(const const_iterator& other) const { return m_index <= other.m_index; }
+			bool operator>=(const const_iterator& other) const { return m_index >= other.m_index; }
+		};
+
+		typedef const_iterator iterator;
+
+	public:
+		_persistent_vector_base() : m_root(nullptr), m_tail(nullptr), m_size(0), m_shift(0) { }
+
+		explicit _persistent_vector_base(const _Allocator& alloc) :
+			allocator_type(alloc), m_root(nullptr), m_tail(nullptr), m_size(0), m_shift(0) { }
+
+		/* shares every node with other */
+		_persistent_vector_base(const self_type& other) :
+			allocator_type(other),
+			m_root(other.m_root), m_tail(other.m_tail), m_size(other.m_size), m_shift(other.m_shift) {
+			_retain(m_root);
+			_retain(m_tail);
+		}
+
+		_persistent_vector_base(self_type&& other) noexcept :
+			allocator_type(std::move((allocator_type&) other)),
+			m_root(other.m_root), m_tail(other.m_tail), m_size(other.m_size), m_shift(other.m_shift) {
+			other.m_root  = nullptr;
+			other.m_tail  = nullptr;
+			other.m_size  = 0;
+			other.m_shift = 0;
+		}
+
+		self_type& operator=(const self_type&) = delete;
+
+		~_persistent_vector_base() {
+			_release(m_root, m_shift);
+			_release(m_tail, 0);
+		}
+
+	public:
+		const_reference operator[](size_type index) const {
+			assert(index < m_size);
+			return _leaf_for(index)->data()[index & _mask];
+		}
+
+		const_reference at(size_type index) const {
+			if (m_size <= index) {
+				throw std::out_of_range("persistent vector index out of range");
+			}
+			return operator[](index);
+		}
+
+		_Allocator get_allocator() const { return allocator_type::get_allocator(); }
+
+		bool empty() const { return 0 == m_size; }
+		size_type size() const { return m_size; }
+		size_type max_size() const { return size_type(-1); }
+
+		const_reference front() const { assert(!empty()); return operator[](0); }
+		const_reference back() const { assert(!empty()); return operator[](m_size - 1); }
+
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, m_size); }
+	};
+
+	template <
+		typename _Val,
+		typename _Allocator = std::allocator<_Val>
+	>
+	class transient_vector;
+
+	/* immutable: updates return a new version and leave this one untouched */
+	template <
+		typename _Val,
+		typename _Allocator = std::allocator<_Val>
+	>
+	class persistent_vector : public _persistent_vector_base<_Val, _Allocator> {
+	protected:
+		typedef _persistent_vector_base<_Val, _Allocator> base_type;
+		typedef persistent_vector<_Val, _Allocator>       self_type;
+
+		friend class transient_vector<_Val, _Allocator>;
+
+	public:
+		typedef typename base_type::value_type      value_type;
+		typedef typename base_type::size_type       size_type;
+		typedef transient_vector<_Val, _Allocator>  transient_type;
+
+	public:
+		persistent_vector() = default;
+		explicit persistent_vector(const _Allocator& alloc) : base_type(alloc) { }
+
+		persistent_vector(const self_type&) = default;
+		persistent_vector(self_type&&) noexcept = default;
+
+		self_type& operator=(const self_type& other) {
+			self_type tmp(other);
+			this->_swap(tmp);
+			return *this;
+		}
+
+		self_type& operator=(self_type&& other) noexcept {
+			self_type tmp(std::move(other));
+			this->_swap(tmp);
+			return *this;
+		}
+
+	public:
+		self_type push_back(const value_type& val) const {
+			self_type result(*this);
+			result._push_back(val, 0);
+			return result;
+		}
+
+		self_type push_back(value_type&& val) const {
+			self_type result(*this);
+			result._push_back(std::move(val), 0);
+			return result;
+		}
+
+		self_type pop_back() const {
+			self_type result(*this);
+			result._pop_back(0);
+			return result;
+		}
+
+		self_type set(size_type index, const value_type& val) const {
+			self_type result(*this);
+			result._set(index, val, 0);
+			return result;
+		}
+
+		/* a batch editor starting from this version, O(1) */
+		transient_type transient() const { return transient_type(*this); }
+
+		void swap(self_type& other) { this->_swap(other); }
+	};
+
+	/*
+	 * Mutable view for bulk edits. Nodes it copies are tagged with its
+	 * owner id and edited in place from then on, so a run of push_backs
+	 * costs what it would in a sequence. persistent() hands out the
+	 * current version and retires the id, later edits copy again.
+	 */
+	template <typename _Val, typename _Allocator>
+	class transient_vector : public _persistent_vector_base<_Val, _Allocator> {
+	protected:
+		typedef _persistent_vector_base<_Val, _Allocator> base_type;
+		typedef transient_vector<_Val, _Allocator>        self_type;
+
+	public:
+		typedef typename base_type::value_type       value_type;
+		typedef typename base_type::size_type        size_type;
+		typedef persistent_vector<_Val, _Allocator>  persistent_type;
+
+	private:
+		uint64_t m_owner;
+
+	public:
+		transient_vector() : m_owner(base_type::_new_owner()) { }
+
+		explicit transient_vector(const persistent_type& from) :
+			base_type(from), m_owner(base_type::_new_owner()) { }
+
+		transient_vector(const self_type&) = delete;
+		self_type& operator=(const self_type&) = delete;
+
+		transient_vector(self_type&& other) noexcept :
+			base_type(std::move(other)), m_owner(other.m_owner) {
+			other.m_owner = base_type::_new_owner();
+		}
+
+	public:
+		void push_back(const value_type& val) { this->_push_back(val, m_owner); }
+		void push_back(value_type&& val) { this->_push_back(std::move(val), m_owner); }
+
+		void pop_back() { this->_pop_back(m_owner); }
+
+		void set(size_type index, const value_type& val) { this->_set(index, val, m_owner); }
+		void set(size_type index, value_type&& val) { this->_set(index, std::move(val), m_owner); }
+
+		persistent_type persistent() {
+			persistent_type result;
+			base_type       shared(*this);
+			result._swap(shared);
+			m_owner = base_type::_new_owner();
+			return result;
+		}
+	};
+
+	template <typename _Val, typename _Allocator>
+	inline void swap(persistent_vector<_Val, _Allocator>& left,
+	                 persistent_vector<_Val, _Allocator>& right) {
+		left.swap(right);
+	}
+}
+
+#endif //_PERSISTENT_VECTOR_H_
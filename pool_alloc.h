@@ -0,0 +1,210 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _POOL_ALLOC_H_
+#define _POOL_ALLOC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace tools {
+
+	/*
+	 * Size-class pool: requests up to _max_bytes are rounded up to a
+	 * multiple of _align and carved from slabs of their class. Slabs are
+	 * aligned to their own size, so a block finds its slab by masking its
+	 * address and goes back to it in O(1). Each class keeps at most one
+	 * empty slab as a spare, the rest are unmapped. Larger requests go
+	 * straight to operator new.
+	 *
+	 * The size classes are shared by every pool_alloc in the process, so
+	 * each class has its own lock: containers on different threads may
+	 * use the pool at once, but every allocation takes that lock. When
+	 * many threads churn the same sizes, thread_cache_alloc scales better.
+	 */
+	class pool_alloc {
+	public:
+		enum {
+			_align       = 16,
+			_max_bytes   = 512,
+			_num_classes = _max_bytes / _align,
+			_slab_size   = 64 * 1024
+		};
+
+	private:
+		struct _block {
+			_block* next;
+		};
+
+		struct _slab {
+			_slab*  prev;
+			_slab*  next;
+			_block* free_list;
+			char*   bump;  /* blocks from bump on were never handed out */
+			size_t  used;
+			size_t  index;
+		};
+
+		struct _size_class {
+			std::mutex lock;
+			_slab*     partial; /* slabs with at least one free block */
+			_slab*     spare;   /* at most one empty slab */
+		};
+
+		static _size_class* _classes() {
+			static _size_class classes[_num_classes];
+			return classes;
+		}
+
+		static size_t _index_of(size_t n) { return 0 == n ? 0 : (n - 1) / _align; }
+		static size_t _block_size(size_t index) { return (index + 1) * _align; }
+
+		static size_t _header_size() {
+			return (sizeof (_slab) + _align - 1) & ~size_t(_align - 1);
+		}
+
+		static _slab* _slab_of(void* p) {
+			return (_slab*) ((uintptr_t) p & ~uintptr_t(_slab_size - 1));
+		}
+
+		static bool _full(const _slab* slab) {
+			return nullptr == slab->free_list &&
+			       (const char*) slab + _slab_size < slab->bump + _block_size(slab->index);
+		}
+
+		static _slab* _map_slab(size_t index) {
+			const size_t length = 2 * _slab_size;
+			void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+			               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (MAP_FAILED == p) {
+				throw std::bad_alloc();
+			}
+
+			/* over-map, then trim to a _slab_size aligned window */
+			uintptr_t raw     = (uintptr_t) p;
+			uintptr_t aligned = (raw + _slab_size - 1) & ~uintptr_t(_slab_size - 1);
+			if (raw != aligned) {
+				munmap(p, aligned - raw);
+			}
+			size_t tail = raw + length - (aligned + _slab_size);
+			if (0 != tail) {
+				munmap((void*) (aligned + _slab_size), tail);
+			}
+
+			_slab* slab = (_slab*) aligned;
+			slab->prev      = nullptr;
+			slab->next      = nullptr;
+			slab->free_list = nullptr;
+			slab->bump      = (char*) slab + _header_size();
+			slab->used      = 0;
+			slab->index     = index;
+			return slab;
+		}
+
+		static void _push_front(_size_class& sc, _slab* slab) {
+			slab->prev = nullptr;
+			slab->next = sc.partial;
+			if (nullptr != sc.partial) {
+				sc.partial->prev = slab;
+			}
+			sc.partial = slab;
+		}
+
+		static void _unlink(_size_class& sc, _slab* slab) {
+			if (nullptr != slab->prev) {
+				slab->prev->next = slab->next;
+			}
+			else {
+				sc.partial = slab->next;
+			}
+			if (nullptr != slab->next) {
+				slab->next->prev = slab->prev;
+			}
+			slab->prev = nullptr;
+			slab->next = nullptr;
+		}
+
+	public:
+		static void* allocate(size_t n) {
+			if (_max_bytes < n) {
+				return ::operator new(n);
+			}
+
+			size_t index = _index_of(n);
+			_size_class& sc = _classes()[index];
+			std::lock_guard<std::mutex> guard(sc.lock);
+
+			_slab* slab = sc.partial;
+			if (nullptr == slab) {
+				if (nullptr != sc.spare) {
+					slab = sc.spare;
+					sc.spare = nullptr;
+				}
+				else {
+					slab = _map_slab(index);
+				}
+				_push_front(sc, slab);
+			}
+
+			void* result = nullptr;
+			if (nullptr != slab->free_list) {
+				result = slab->free_list;
+				slab->free_list = slab->free_list->next;
+			}
+			else {
+				result = slab->bump;
+				slab->bump += _block_size(index);
+			}
+			++slab->used;
+
+			if (_full(slab)) {
+				_unlink(sc, slab);
+			}
+			return result;
+		}
+
+		static size_t good_size(size_t n) {
+			return _max_bytes < n ? n : _block_size(_index_of(n));
+		}
+
+		static void deallocate(void* p, size_t n) {
+			if (nullptr == p) {
+				return;
+			}
+
+			if (_max_bytes < n) {
+				::operator delete(p);
+				return;
+			}
+
+			_slab* slab = _slab_of(p);
+			_size_class& sc = _classes()[slab->index];
+			std::lock_guard<std::mutex> guard(sc.lock);
+
+			if (_full(slab)) {
+				_push_front(sc, slab);
+			}
+
+			_block* block = (_block*) p;
+			block->next = slab->free_list;
+			slab->free_list = block;
+
+			if (0 == --slab->used) {
+				_unlink(sc, slab);
+				if (nullptr == sc.spare) {
+					sc.spare = slab;
+				}
+				else {
+					munmap(slab, _slab_size);
+				}
+			}
+		}
+	};
+}
+
+#endif //_POOL_ALLOC_H_
@@ -7,15 +7,11 @@
 
 #include <utility>
 
-namespace tools {
+#include "deque.h"
 
-	template <
-		typename _Val,
-		typename _Allocator
-	>
-	class sequence;
+namespace tools {
 
-	template <typename _Val, typename _Container = sequence<_Val>>
+	template <typename _Val, typename _Container = deque<_Val>>
 	class queue {
 	public:
 		typedef typename _Container::value_type      value_type;
@@ -46,9 +42,14 @@ namespace tools {
 
 		void pop() { m_container.pop_front(); }
 		void push(const value_type& val) { return m_container.push_back(val); }
+		void push(value_type&& val) { return m_container.push_back(std::move(val)); }
 
 		template <typename... _Args>
 		void emplace(_Args&&... args) { m_container.emplace_back(std::forward<_Args>(args)...); }
+
+		/* batches, for containers that offer them */
+		void push_n(const value_type* src, size_type n) { m_container.push_n(src, n); }
+		size_type pop_n(value_type* dst, size_type n) { return m_container.pop_n(dst, n); }
 	};
 }
 
@@ -317,7 +317,7 @@ namespace tools {
 		typename _Comparator = less<_Key>,
 		typename _Allocator  = std::allocator<_rb_tree_node<_Val>>
 	>
-	class _rb_tree {
+	class _rb_tree : private standard_alloc<_rb_tree_node<_Val>, _Allocator> {
 	public:
 		typedef _Key        key_type;
 		typedef _Val        value_type;
@@ -392,7 +392,24 @@ namespace tools {
 		}
 
 		void _clear() {
-			// todo
+			if (!_trivial_teardown<value_type, _Allocator>::value) {
+				_erase_subtree(root());
+			}
+
+			root()      = nullptr;
+			leftmost()  = m_header;
+			rightmost() = m_header;
+			m_count     = 0;
+		}
+
+		/* recurse on the right, loop on the left */
+		void _erase_subtree(link_type p) {
+			while (nullptr != p) {
+				_erase_subtree(static_cast<link_type>(p->right()));
+				link_type left = static_cast<link_type>(p->left());
+				destroy_node(p);
+				p = left;
+			}
 		}
 
 		iterator _insert(link_type current, link_type parent, const value_type& val) {
@@ -431,8 +448,9 @@ namespace tools {
 		}
 
 	public:
-		explicit _rb_tree(const comparator_type& comp = _Comparator()) :
-			m_count(0), m_comp(comp) { _initialize(); }
+		explicit _rb_tree(const comparator_type& comp  = _Comparator(),
+		                  const _Allocator&      alloc = _Allocator()) :
+			allocator_type(alloc), m_count(0), m_comp(comp) { _initialize(); }
 
 		~_rb_tree() {
 			_clear();
@@ -447,6 +465,8 @@ namespace tools {
 	public:
 		const comparator_type& comparator() const { return m_comp; }
 
+		_Allocator get_allocator() const { return allocator_type::get_allocator(); }
+
 		iterator begin() { return inner_iterator(leftmost()); }
 		const_iterator begin() const { return const_inner_iterator(leftmost()); }
 
@@ -463,6 +483,8 @@ namespace tools {
 		size_type size() const { return m_count; }
 		size_type max_size() const { return size_type(-1); }
 
+		void clear() { _clear(); }
+
 		const_iterator minimum() const {
 			if (empty()) {
 				return end();
@@ -553,7 +575,7 @@ namespace tools {
 				}
 			}
 
-			inner_iterator iter(parent);
+			iterator iter = inner_iterator(parent);
 			return (end() == iter || m_comp(key, key_of(*iter))) ? end() : iter;
 		}
 	};
@@ -5,19 +5,56 @@
 #ifndef _SEQUENCE_H_
 #define _SEQUENCE_H_
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
 
 #include "iterator.h"
 #include "memory.h"
 
 namespace tools {
 
+	/*
+	 * growth policies: next(capacity, alloc) is the capacity a full
+	 * sequence grows to, alloc being its standard_alloc.
+	 */
+	namespace growth {
+
+		struct doubling {
+			template <typename _Alloc>
+			static size_t next(size_t capacity, const _Alloc&) {
+				return 0 == capacity ? 1 : capacity * 2;
+			}
+		};
+
+		struct one_and_half {
+			template <typename _Alloc>
+			static size_t next(size_t capacity, const _Alloc&) {
+				return capacity < 2 ? capacity + 1 : capacity + capacity / 2;
+			}
+		};
+
+		/* rounds _Base's choice up to the block the allocator really returns */
+		template <typename _Base = doubling>
+		struct size_class_aware {
+			template <typename _Alloc>
+			static size_t next(size_t capacity, const _Alloc& alloc) {
+				return alloc.good_size(_Base::next(capacity, alloc));
+			}
+		};
+
+	}
+
 	template <
 		typename _Val,
-		typename _Allocator = std::allocator<_Val>
+		typename _Allocator = std::allocator<_Val>,
+		typename _Growth    = growth::doubling
 	>
-	class sequence {
+	class sequence : private standard_alloc<_Val, _Allocator> {
 	public:
 		typedef _Val        value_type;
 		typedef _Val&       reference;
@@ -29,8 +66,9 @@ namespace tools {
 		typedef size_t    size_type;
 
 	protected:
-		typedef sequence<_Val, _Allocator>       self_type;
-		typedef standard_alloc<_Val, _Allocator> allocator_type;
+		typedef sequence<_Val, _Allocator, _Growth> self_type;
+		typedef standard_alloc<_Val, _Allocator>    allocator_type;
+		typedef _Growth                             growth_type;
 
 		typedef pointer       inner_iterator;
 		typedef const_pointer const_inner_iterator;
@@ -47,7 +85,7 @@ namespace tools {
 	private:
 		void _initialize_with_n(size_type n) throw (std::bad_alloc) {
 			m_base = get_space(n);
-			if (nullptr == m_base) {
+			if (nullptr == m_base && 0 != n) {
 				throw std::bad_alloc();
 			}
 			m_finish = m_base + n;
@@ -56,120 +94,294 @@ namespace tools {
 
 		template <typename _InputIterator>
 		void _fill(_InputIterator first, _InputIterator last) {
-			while (first != last) {
-				construct(m_end++, *first);
-				++first;
+			m_end = tools::uninitialized_copy(first, last, m_end);
+		}
+
+		pointer _allocate(size_type n) {
+			pointer p = get_space(n);
+			if (nullptr == p && 0 != n) {
+				throw std::bad_alloc();
 			}
+			return p;
 		}
 
-		void _fill(pointer first, pointer last) {
-			size_type offset = last - first;
-			memcpy(m_base, first, sizeof (value_type) * offset);
-			m_end = m_base + offset;
+		void _adopt(pointer new_base, pointer new_end, size_type new_capacity) {
+			put_space(m_base, capacity());
+			m_base   = new_base;
+			m_end    = new_end;
+			m_finish = new_base + new_capacity;
 		}
 
-		void _extend(size_type new_size) {
-			inner_iterator old_base = m_base;
-			inner_iterator old_end  = m_end;
-			inner_iterator old_finish = m_finish;
+		/* the allocator can resize the buffer in place and the elements may move bitwise */
+		typedef _bool_type<
+			allocator_type::can_reallocate::value && _is_trivially_relocatable<_Val>::value
+		> _resizes_in_place;
 
+		void _extend(size_type new_capacity) { _extend(new_capacity, _resizes_in_place()); }
+
+		void _extend(size_type new_capacity, _true_type) {
+			size_type n = size();
+			m_base   = allocator_type::reallocate(m_base, capacity(), new_capacity);
+			m_end    = m_base + n;
+			m_finish = m_base + new_capacity;
+		}
+
+		void _extend(size_type new_capacity, _false_type) {
+			pointer new_base = _allocate(new_capacity);
+			pointer new_end  = nullptr;
 			try {
-				_initialize_with_n(new_size);
+				new_end = _relocate_with_gap(m_base, m_end, m_end, new_base, 0);
 			}
 			catch (...) {
-				m_base = old_base;
-				m_end  = old_end;
-				m_finish = old_finish;
+				put_space(new_base, new_capacity);
 				throw;
 			}
+			_adopt(new_base, new_end, new_capacity);
+		}
 
-			_fill(old_base, old_end);
-			put_space(old_base, old_finish - old_base);
+		size_type _next_capacity() const {
+			return growth_type::next(capacity(), (const allocator_type&) *this);
 		}
 
-		void _extend_when_full() {
-			_extend(0 == capacity() ? 1 : capacity() * 2);
+		template <typename... _Args>
+		inner_iterator _realloc_emplace(difference_type offset, _Args&&... args) {
+			return _grow_emplace(offset, _resizes_in_place(), std::forward<_Args>(args)...);
 		}
 
-		void _resize(size_type new_size) {
-			if (capacity() == new_size) {
-				return;
+		/* args may refer into the buffer the allocator is about to move */
+		template <typename... _Args>
+		inner_iterator _grow_emplace(difference_type offset, _true_type, _Args&&... args) {
+			value_type tmp(std::forward<_Args>(args)...);
+			_extend(_next_capacity(), _true_type());
+
+			inner_iterator p = m_base + offset;
+			if (m_end == p) {
+				construct(p, std::move(tmp));
+			}
+			else {
+				_insert_shifting(p, m_end, tmp);
+			}
+			++m_end;
+
+			return p;
+		}
+
+		/* constructs the new element first, args may refer into the old buffer */
+		template <typename... _Args>
+		inner_iterator _grow_emplace(difference_type offset, _false_type, _Args&&... args) {
+			size_type new_capacity = _next_capacity();
+			pointer new_base = _allocate(new_capacity);
+			pointer new_end  = nullptr;
+
+			try {
+				construct(new_base + offset, std::forward<_Args>(args)...);
+			}
+			catch (...) {
+				put_space(new_base, new_capacity);
+				throw;
 			}
 
-			if (capacity() < new_size) {
-				_extend(new_size);
+			try {
+				new_end = _relocate_with_gap(m_base, m_base + offset, m_end, new_base, 1);
 			}
-			else if (size() < new_size) {
-				construct(m_end, m_base + new_size, value_type());
-				m_end = m_base + new_size;
+			catch (...) {
+				destroy(new_base + offset);
+				put_space(new_base, new_capacity);
+				throw;
+			}
+
+			_adopt(new_base, new_end, new_capacity);
+			return m_base + offset;
+		}
+
+		void _resize(size_type new_size) {
+			if (size() < new_size) {
+				if (capacity() < new_size) {
+					_extend(new_size);
+				}
+				construct(m_end, m_base + new_size);
 			}
 			else {
 				destroy(m_base + new_size, m_end);
-				m_end = m_base + new_size;
 			}
+			m_end = m_base + new_size;
 		}
 
-		void _swap() { /* todo */ }
+		void _swap(self_type& other) {
+			std::swap((allocator_type&) *this, (allocator_type&) other);
+			std::swap(m_base, other.m_base);
+			std::swap(m_end, other.m_end);
+			std::swap(m_finish, other.m_finish);
+		}
 
 		void _destroy() {
-			inner_iterator cursor = m_base;
-			while (m_end != cursor) {
-				destroy(cursor);
-				++cursor;
-			}
+			destroy(m_base, m_end);
 			put_space(m_base, capacity());
 		}
 
 		bool _full() const { return m_end == m_finish; }
 
-		/* [start, end) */
-		void _copy_backward(inner_iterator start    ,
-		                    inner_iterator end      ,
-		                    inner_iterator new_start) {
-			difference_type offset = new_start - start;
-			inner_iterator p = end + offset - 1;
+		template <typename... _Args>
+		inner_iterator _emplace(difference_type offset, _Args&&... args) {
+			if (_full()) {
+				return _realloc_emplace(offset, std::forward<_Args>(args)...);
+			}
 
-			while (new_start <= p) {
-				memcpy(p, p - offset, sizeof (value_type));
-				--p;
+			inner_iterator p = m_base + offset;
+			if (m_end == p) {
+				construct(p, std::forward<_Args>(args)...);
+			}
+			else {
+				/* args may refer to an element about to be shifted */
+				value_type tmp(std::forward<_Args>(args)...);
+				_insert_shifting(p, m_end, tmp);
 			}
+			++m_end;
+
+			return p;
 		}
 
-		void _copy_forward(inner_iterator start, inner_iterator end, inner_iterator new_start) {
-			while (start != end) {
-				memcpy(new_start++, start++, sizeof (value_type));
+		/*
+		 * opens n slots at offset with a single shift of the tail, or a
+		 * single reallocation, and has fill(p) construct [p, p + n).
+		 * On reallocation the new elements are built before the old ones
+		 * move, so fill may still read from the old buffer, unless the
+		 * allocator resizes the buffer in place. A tail whose moves may
+		 * throw is not shifted, it goes to a new buffer as on reallocation.
+		 */
+		template <typename _Filler>
+		inner_iterator _insert_n(difference_type offset, size_type n, _Filler fill) {
+			if (0 == n) {
+				return m_base + offset;
 			}
-		}
 
-		template <typename... _Args>
-		inner_iterator _emplace(difference_type offset, _Args&&... args) {
-			if (_full()) {
-				_extend_when_full();
+			if (size_type(m_finish - m_end) < n && _resizes_in_place::value) {
+				_extend(std::max(_next_capacity(), size() + n));
+			}
+
+			bool room = n <= size_type(m_finish - m_end);
+			if (!room || (!_shifts_by_relocation<_Val>::value && m_base + offset != m_end)) {
+				size_type new_capacity = room ? capacity() : std::max(_next_capacity(), size() + n);
+				pointer new_base = _allocate(new_capacity);
+				pointer new_end  = nullptr;
+
+				try {
+					fill(new_base + offset);
+				}
+				catch (...) {
+					put_space(new_base, new_capacity);
+					throw;
+				}
+
+				try {
+					new_end = _relocate_with_gap(m_base, m_base + offset, m_end, new_base, n);
+				}
+				catch (...) {
+					destroy(new_base + offset, new_base + offset + n);
+					put_space(new_base, new_capacity);
+					throw;
+				}
+
+				_adopt(new_base, new_end, new_capacity);
+				return m_base + offset;
 			}
 
 			inner_iterator p = m_base + offset;
-			_copy_backward(p, m_end, p + 1);
-			construct(p, std::forward<_Args>(args)...);
-			++m_end;
+			relocate_backward(p, m_end, m_end + n);
+			try {
+				fill(p);
+			}
+			catch (...) {
+				relocate(p + n, m_end + n, p);
+				throw;
+			}
+			m_end += n;
 
 			return p;
 		}
 
+		template <typename _Integer>
+		inner_iterator _insert_range(difference_type offset,
+		                             _Integer        n     ,
+		                             _Integer        val   ,
+		                             _true_type            ) {
+			return _insert_fill(offset, size_type(n), value_type(val));
+		}
+
+		template <typename _InputIterator>
+		inner_iterator _insert_range(difference_type offset,
+		                             _InputIterator  first ,
+		                             _InputIterator  last  ,
+		                             _false_type           ) {
+			typedef typename
+				_iterator_traits<_InputIterator>::iterator_category
+			category;
+
+			return _insert_range(offset, first, last, category());
+		}
+
+		template <typename _InputIterator>
+		inner_iterator _insert_range(difference_type offset,
+		                             _InputIterator  first ,
+		                             _InputIterator  last  ,
+		                             std::input_iterator_tag) {
+			/* length unknown up front: append, then rotate into place once */
+			size_type old_size = size();
+			while (first != last) {
+				emplace_back(*first);
+				++first;
+			}
+			std::rotate(m_base + offset, m_base + old_size, m_end);
+			return m_base + offset;
+		}
+
+		template <typename _ForwardIterator>
+		inner_iterator _insert_range(difference_type  offset,
+		                             _ForwardIterator first ,
+		                             _ForwardIterator last  ,
+		                             std::forward_iterator_tag) {
+			size_type n = std::distance(first, last);
+			return _insert_n(offset, n, [&](pointer p) {
+				tools::uninitialized_copy(first, last, p);
+			});
+		}
+
+		inner_iterator _insert_fill(difference_type offset, size_type n, const value_type& val) {
+			/* val may live in the tail that is about to shift */
+			value_type tmp(val);
+			return _insert_n(offset, n, [&](pointer p) {
+				construct(p, p + n, tmp);
+			});
+		}
+
 	public:
 		sequence() : m_base(nullptr), m_end(nullptr), m_finish(nullptr) { }
 
-		explicit sequence(size_type capacity)
-			throw (std::bad_alloc) { _initialize_with_n(capacity); }
+		explicit sequence(const _Allocator& alloc) :
+			allocator_type(alloc), m_base(nullptr), m_end(nullptr), m_finish(nullptr) { }
+
+		explicit sequence(size_type capacity, const _Allocator& alloc = _Allocator())
+			throw (std::bad_alloc) : allocator_type(alloc) { _initialize_with_n(capacity); }
 
 		sequence(const self_type& other)
-			throw (std::bad_alloc) {
+			throw (std::bad_alloc) : allocator_type(other) {
 			_initialize_with_n(other.size());
-			_fill(other.begin(), other.end());
+			_fill(other.m_base, other.m_end);
+		}
+
+		sequence(self_type&& other) noexcept :
+			allocator_type(std::move((allocator_type&) other)),
+			m_base(other.m_base), m_end(other.m_end), m_finish(other.m_finish) {
+			other.m_base   = nullptr;
+			other.m_end    = nullptr;
+			other.m_finish = nullptr;
 		}
 
 		template <typename _InputIterator>
-		sequence(_InputIterator first, _InputIterator last) :
-			m_base(nullptr), m_end(nullptr), m_finish(nullptr) {
+		sequence(_InputIterator    first,
+		         _InputIterator    last ,
+		         const _Allocator& alloc = _Allocator()) :
+			allocator_type(alloc), m_base(nullptr), m_end(nullptr), m_finish(nullptr) {
 			while (first != last) {
 				this->push_back(*first);
 				++first;
@@ -184,10 +396,32 @@ namespace tools {
 				return *this;
 			}
 
-			_destroy();
-			_initialize_with_n(other.size());
-			_fill(other.m_base, other.m_end);
+			if (capacity() < other.size()) {
+				pointer new_base = _allocate(other.size());
+				pointer new_end  = nullptr;
+				try {
+					new_end = tools::uninitialized_copy(other.m_base, other.m_end, new_base);
+				}
+				catch (...) {
+					put_space(new_base, other.size());
+					throw;
+				}
+				destroy(m_base, m_end);
+				_adopt(new_base, new_end, other.size());
+			}
+			else {
+				clear();
+				_fill(other.m_base, other.m_end);
+			}
+
+			return *this;
+		}
 
+		self_type& operator=(self_type&& other) noexcept {
+			if (this != &other) {
+				self_type tmp(std::move(other));
+				_swap(tmp);
+			}
 			return *this;
 		}
 
@@ -210,6 +444,8 @@ namespace tools {
 		typedef _reverse_iterator<const_iterator> const_reverse_iterator;
 
 	public:
+		_Allocator get_allocator() const { return allocator_type::get_allocator(); }
+
 		bool empty() const { return m_base == m_end; }
 		size_type size() const { return m_end - m_base; }
 		size_type max_size() const { return size_type(-1); }
@@ -227,12 +463,33 @@ namespace tools {
 		reference back() { return const_cast<reference>(((const self_type*) this)->back()); }
 		const_reference back() const { assert(!empty()); return *(m_end - 1); }
 
-		void clear() { m_end = m_base; }
+		void clear() { destroy(m_base, m_end); m_end = m_base; }
+
+		void reserve(size_type new_capacity) {
+			if (capacity() < new_capacity) {
+				_extend(new_capacity);
+			}
+		}
+
+		void shrink_to_fit() {
+			if (size() == capacity()) {
+				return;
+			}
+
+			if (empty()) {
+				put_space(m_base, capacity());
+				m_base   = nullptr;
+				m_end    = nullptr;
+				m_finish = nullptr;
+				return;
+			}
+			_extend(size());
+		}
 
 		void resize(size_type new_size) { _resize(new_size); }
 
 		template <typename... _Args>
-		iterator emplace(const_reference pos, _Args&&... args) {
+		iterator emplace(const_iterator pos, _Args&&... args) {
 			return iterator(_emplace(pos - begin(), std::forward<_Args>(args)...));
 		}
 
@@ -242,6 +499,7 @@ namespace tools {
 		}
 
 		void push_back(const value_type& val) { insert(end(), val); }
+		void push_back(value_type&& val) { insert(end(), std::move(val)); }
 
 		void pop_back() { erase(--end()); }
 
@@ -249,19 +507,46 @@ namespace tools {
 			return iterator(_emplace(pos - begin(), val));
 		}
 
+		iterator insert(const_iterator pos, value_type&& val) {
+			return iterator(_emplace(pos - begin(), std::move(val)));
+		}
+
+		template <typename _InputIterator>
+		iterator insert(const_iterator pos, _InputIterator first, _InputIterator last) {
+			return iterator(_insert_range(
+				pos - begin(), first, last, _bool_type<std::is_integral<_InputIterator>::value>()
+			));
+		}
+
+		iterator insert(const_iterator pos, size_type n, const value_type& val) {
+			return iterator(_insert_fill(pos - begin(), n, val));
+		}
+
 		iterator erase(const_iterator pos) {
 			if (empty() || end() == pos) {
 				throw std::overflow_error("Invalid iterator or empty sequence.");
 			}
 
-			difference_type offset = pos - begin();
-			inner_iterator to_erase = m_base + offset;
+			inner_iterator to_erase = m_base + (pos - begin());
+			m_end = _erase_shifting(to_erase, to_erase + 1, m_end);
+			return iterator(to_erase);
+		}
 
-			destroy(to_erase);
-			_copy_forward(to_erase + 1, m_end, to_erase);
+		iterator erase(const_iterator first, const_iterator last) {
+			inner_iterator p = m_base + (first - begin());
+			inner_iterator q = m_base + (last - begin());
+			if (p != q) {
+				m_end = _erase_shifting(p, q, m_end);
+			}
+			return iterator(p);
+		}
 
-			--m_end;
-			return iterator(to_erase);
+		/* removes every element matching pred in one pass, returns how many went */
+		template <typename _Predicate>
+		size_type erase_if(_Predicate pred) {
+			inner_iterator old_end = m_end;
+			_erase_if_shifting(m_base, m_end, pred);
+			return old_end - m_end;
 		}
 
 		iterator begin() { return iterator(m_base); }
@@ -275,7 +560,15 @@ namespace tools {
 
 		reverse_iterator rend() { return reverse_iterator(begin()); }
 		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+		void swap(self_type& other) { _swap(other); }
 	};
+
+	template <typename _Val, typename _Allocator, typename _Growth>
+	inline void swap(sequence<_Val, _Allocator, _Growth>& left,
+	                 sequence<_Val, _Allocator, _Growth>& right) {
+		left.swap(right);
+	}
 }
 
 #endif //_SEQUENCE_H_
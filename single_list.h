@@ -5,6 +5,8 @@
 #ifndef _SINGLE_LIST_H_
 #define _SINGLE_LIST_H_
 
+#include <stdexcept>
+
 #include "iterator.h"
 #include "memory.h"
 
@@ -130,7 +132,7 @@ namespace tools {
 		typename _Val,
 		typename _Allocator = std::allocator<slist_node<_Val>>
 	>
-	class single_list {
+	class single_list : private standard_alloc<slist_node<_Val>, _Allocator> {
 	public:
 		typedef _Val        value_type;
 		typedef _Val*       pointer;
@@ -185,8 +187,13 @@ namespace tools {
 		}
 
 		void _clear() {
-			while (!empty()) {
-				_erase_after(m_before_head);
+			if (_trivial_teardown<value_type, _Allocator>::value) {
+				head() = m_before_head;
+			}
+			else {
+				while (!empty()) {
+					_erase_after(m_before_head);
+				}
 			}
 			tail() = m_before_head;
 		}
@@ -208,8 +215,12 @@ namespace tools {
 	public:
 		single_list() { _initialize(); }
 
+		explicit single_list(const _Allocator& alloc) : allocator_type(alloc) { _initialize(); }
+
 		template <typename _InputIterator>
-		single_list(_InputIterator first, _InputIterator last) {
+		single_list(_InputIterator    first,
+		            _InputIterator    last ,
+		            const _Allocator& alloc = _Allocator()) : allocator_type(alloc) {
 			_initialize();
 			while (first != last) {
 				this->push_back(*first);
@@ -217,6 +228,28 @@ namespace tools {
 			}
 		}
 
+		single_list(const self_type& other) : allocator_type(other) {
+			_initialize();
+			try {
+				for (const_iterator it = other.begin(); it != other.end(); ++it) {
+					this->push_back(*it);
+				}
+			}
+			catch (...) {
+				_clear();
+				put_node(m_before_head);
+				throw;
+			}
+		}
+
+		self_type& operator=(const self_type& other) {
+			if (this != &other) {
+				self_type tmp(other);
+				swap(tmp);
+			}
+			return *this;
+		}
+
 		~single_list() {
 			_clear();
 			put_node(m_before_head);
@@ -233,6 +266,8 @@ namespace tools {
 		typedef _reverse_iterator<const_iterator> const_reverse_iterator;
 
 	public:
+		_Allocator get_allocator() const { return allocator_type::get_allocator(); }
+
 		bool empty() const { return head() == m_before_head; }
 
 		size_type size() const {
@@ -300,6 +335,12 @@ namespace tools {
 
 		void push_back(const value_type& val) { tail() = _insert_after(tail(), val); }
 
+		void swap(self_type& other) {
+			std::swap((allocator_type&) *this, (allocator_type&) other);
+			std::swap(m_before_head, other.m_before_head);
+			std::swap(m_tail, other.m_tail);
+		}
+
 		iterator begin() { return inner_iterator(head()); }
 		const_iterator begin() const { return const_inner_iterator(head()); }
 
@@ -0,0 +1,286 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _SLOT_MAP_H_
+#define _SLOT_MAP_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "sequence.h"
+
+namespace tools {
+
+	/* index of a slot in the low half, its generation in the high half */
+	class slot_handle {
+	private:
+		uint64_t m_bits;
+
+	public:
+		slot_handle() : m_bits(0) { }
+		explicit slot_handle(uint64_t bits) : m_bits(bits) { }
+		slot_handle(uint32_t index, uint32_t generation) :
+			m_bits(uint64_t(generation) << 32 | index) { }
+
+	public:
+		uint32_t index() const { return uint32_t(m_bits); }
+		uint32_t generation() const { return uint32_t(m_bits >> 32); }
+		uint64_t value() const { return m_bits; }
+
+		/* generation 0 is never handed out, a default handle is always stale */
+		bool null() const { return 0 == generation(); }
+
+		bool operator==(const slot_handle& other) const { return m_bits == other.m_bits; }
+		bool operator!=(const slot_handle& other) const { return m_bits != other.m_bits; }
+	};
+
+	/*
+	 * Values packed in a sequence, reached through handles that survive
+	 * any insert or erase. Each slot records where its value sits and a
+	 * generation that moves on when the value is erased, so an old handle
+	 * to a reused slot no longer matches. Erasing moves the last value
+	 * into the hole; freed slots are chained for reuse.
+	 *
+	 * Iteration runs over the packed values in no particular order,
+	 * handle_at() gives the handle of the value at a position.
+	 */
+	template <
+		typename _Val,
+		typename _Allocator = std::allocator<_Val>,
+		typename _Growth    = growth::doubling
+	>
+	class slot_map {
+	public:
+		typedef _Val        value_type;
+		typedef _Val&       reference;
+		typedef const _Val& const_reference;
+		typedef _Val*       pointer;
+		typedef const _Val* const_pointer;
+
+		typedef ptrdiff_t   difference_type;
+		typedef size_t      size_type;
+		typedef slot_handle handle_type;
+
+	protected:
+		typedef slot_map<_Val, _Allocator, _Growth> self_type;
+
+		struct _slot {
+			uint32_t generation;
+			uint32_t position; /* of the value while in use, next free slot otherwise */
+		};
+
+		static constexpr uint32_t _npos = uint32_t(-1);
+
+		typedef sequence<_Val, _Allocator, _Growth>     value_sequence;
+		typedef sequence<uint32_t, _Allocator, _Growth> owner_sequence;
+		typedef sequence<_slot, _Allocator, _Growth>    slot_sequence;
+
+	public:
+		typedef typename value_sequence::iterator       iterator;
+		typedef typename value_sequence::const_iterator const_iterator;
+
+	private:
+		value_sequence m_values;
+		owner_sequence m_owners; /* slot of each value */
+		slot_sequence  m_slots;
+		uint32_t       m_free;
+
+	protected:
+		const _slot* _lookup(handle_type handle) const {
+			if (m_slots.size() <= handle.index()) {
+				return nullptr;
+			}
+			const _slot& slot = m_slots[handle.index()];
+			return slot.generation == handle.generation() ? &slot : nullptr;
+		}
+
+		void _retire(uint32_t index) {
+			_slot& slot = m_slots[index];
+			if (0 == ++slot.generation) {
+				slot.generation = 1;
+			}
+			slot.position = m_free;
+			m_free = index;
+		}
+
+	public:
+		slot_map() : m_free(_npos) { }
+
+		explicit slot_map(const _Allocator& alloc) :
+			m_values(alloc), m_owners(alloc), m_slots(alloc), m_free(_npos) { }
+
+		slot_map(const self_type&) = default;
+
+		slot_map(self_type&& other) noexcept :
+			m_values(std::move(other.m_values)),
+			m_owners(std::move(other.m_owners)),
+			m_slots(std::move(other.m_slots)),
+			m_free(other.m_free) {
+			other.m_free = _npos;
+		}
+
+		self_type& operator=(const self_type& other) {
+			if (this != &other) {
+				self_type tmp(other);
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		self_type& operator=(self_type&& other) noexcept {
+			if (this != &other) {
+				self_type tmp(std::move(other));
+				swap(tmp);
+			}
+			return *this;
+		}
+
+	public:
+		template <typename... _Args>
+		handle_type emplace(_Args&&... args) {
+			if (_npos == m_free) {
+				if (_npos - 1 <= m_slots.size()) {
+					throw std::length_error("slot_map is out of slots");
+				}
+				/* a fresh slot joins the free list first, it stays there if anything below throws */
+				_slot slot = { 1, _npos };
+				m_slots.push_back(slot);
+				m_free = uint32_t(m_slots.size() - 1);
+			}
+
+			m_values.emplace_back(std::forward<_Args>(args)...);
+			try {
+				m_owners.push_back(m_free);
+			}
+			catch (...) {
+				m_values.pop_back();
+				throw;
+			}
+
+			uint32_t index = m_free;
+			_slot&   slot  = m_slots[index];
+			m_free = slot.position;
+			slot.position = uint32_t(m_values.size() - 1);
+			return handle_type(index, slot.generation);
+		}
+
+		handle_type insert(const value_type& val) { return emplace(val); }
+		handle_type insert(value_type&& val) { return emplace(std::move(val)); }
+
+		/* false when handle is stale */
+		bool erase(handle_type handle) {
+			const _slot* slot = _lookup(handle);
+			if (nullptr == slot) {
+				return false;
+			}
+
+			size_type position = slot->position;
+			size_type last     = m_values.size() - 1;
+			if (position != last) {
+				m_values[position] = std::move(m_values[last]);
+				m_owners[position] = m_owners[last];
+				m_slots[m_owners[position]].position = uint32_t(position);
+			}
+			m_values.pop_back();
+			m_owners.pop_back();
+			_retire(handle.index());
+			return true;
+		}
+
+		iterator erase(const_iterator pos) {
+			size_type position = pos - ((const value_sequence&) m_values).begin();
+			erase(handle_at(position));
+			return m_values.begin() + position;
+		}
+
+		void clear() {
+			for (size_type i = 0; i < m_owners.size(); ++i) {
+				_retire(m_owners[i]);
+			}
+			m_values.clear();
+			m_owners.clear();
+		}
+
+		bool contains(handle_type handle) const { return nullptr != _lookup(handle); }
+
+		/* nullptr when handle is stale */
+		const_pointer find(handle_type handle) const {
+			const _slot* slot = _lookup(handle);
+			return nullptr == slot ? nullptr : &m_values[slot->position];
+		}
+
+		pointer find(handle_type handle) {
+			return const_cast<pointer>(((const self_type*) this)->find(handle));
+		}
+
+		const_reference operator[](handle_type handle) const {
+			assert(contains(handle));
+			return m_values[m_slots[handle.index()].position];
+		}
+
+		reference operator[](handle_type handle) {
+			return const_cast<reference>(((const self_type*) this)->operator[](handle));
+		}
+
+		const_reference at(handle_type handle) const {
+			const_pointer p = find(handle);
+			if (nullptr == p) {
+				throw std::out_of_range("stale slot_map handle");
+			}
+			return *p;
+		}
+
+		reference at(handle_type handle) {
+			return const_cast<reference>(((const self_type*) this)->at(handle));
+		}
+
+		handle_type handle_at(size_type position) const {
+			assert(position < size());
+			uint32_t index = m_owners[position];
+			return handle_type(index, m_slots[index].generation);
+		}
+
+	public:
+		_Allocator get_allocator() const { return m_values.get_allocator(); }
+
+		bool empty() const { return m_values.empty(); }
+		size_type size() const { return m_values.size(); }
+		size_type max_size() const { return _npos - 1; }
+		size_type capacity() const { return m_values.capacity(); }
+
+		void reserve(size_type new_capacity) {
+			m_values.reserve(new_capacity);
+			m_owners.reserve(new_capacity);
+			m_slots.reserve(new_capacity);
+		}
+
+		iterator begin() { return m_values.begin(); }
+		const_iterator begin() const { return m_values.begin(); }
+
+		iterator end() { return m_values.end(); }
+		const_iterator end() const { return m_values.end(); }
+
+		void swap(self_type& other) {
+			m_values.swap(other.m_values);
+			m_owners.swap(other.m_owners);
+			m_slots.swap(other.m_slots);
+			std::swap(m_free, other.m_free);
+		}
+	};
+
+	template <typename _Val, typename _Allocator, typename _Growth>
+	constexpr uint32_t slot_map<_Val, _Allocator, _Growth>::_npos;
+
+	template <typename _Val, typename _Allocator, typename _Growth>
+	inline void swap(slot_map<_Val, _Allocator, _Growth>& left,
+	                 slot_map<_Val, _Allocator, _Growth>& right) {
+		left.swap(right);
+	}
+}
+
+#endif //_SLOT_MAP_H_
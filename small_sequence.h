@@ -0,0 +1,520 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _SMALL_SEQUENCE_H_
+#define _SMALL_SEQUENCE_H_
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.h"
+#include "memory.h"
+#include "sequence.h"
+
+namespace tools {
+
+	/*
+	 * sequence with room for _N elements inside the object itself. Only
+	 * growing past _N touches the allocator; shrink_to_fit moves back
+	 * inline once the elements fit again.
+	 */
+	template <
+		typename _Val,
+		size_t   _N,
+		typename _Allocator = std::allocator<_Val>,
+		typename _Growth    = growth::doubling
+	>
+	class small_sequence : private standard_alloc<_Val, _Allocator> {
+		static_assert(0 < _N, "small_sequence needs inline room for an element");
+
+	public:
+		typedef _Val        value_type;
+		typedef _Val&       reference;
+		typedef const _Val& const_reference;
+		typedef _Val*       pointer;
+		typedef const _Val* const_pointer;
+
+		typedef ptrdiff_t difference_type;
+		typedef size_t    size_type;
+
+	protected:
+		typedef small_sequence<_Val, _N, _Allocator, _Growth> self_type;
+		typedef standard_alloc<_Val, _Allocator>              allocator_type;
+		typedef _Growth                                       growth_type;
+
+		typedef pointer       inner_iterator;
+		typedef const_pointer const_inner_iterator;
+
+	private:
+		inner_iterator m_base;
+		inner_iterator m_end;
+		inner_iterator m_finish;
+
+		typename std::aligned_storage<sizeof (_Val) * _N, alignof (_Val)>::type m_inline;
+
+	protected:
+		pointer get_space(size_type n) { return allocator_type::allocate(n); }
+		void put_space(pointer p, size_type n) { return allocator_type::deallocate(p, n); }
+
+	private:
+		pointer _inline_base() { return (pointer) &m_inline; }
+		bool _is_inline() const { return m_base == (const_pointer) &m_inline; }
+
+		void _reset_inline() {
+			m_base   = _inline_base();
+			m_end    = m_base;
+			m_finish = m_base + _N;
+		}
+
+		pointer _allocate(size_type n) {
+			pointer p = get_space(n);
+			if (nullptr == p && 0 != n) {
+				throw std::bad_alloc();
+			}
+			return p;
+		}
+
+		void _release() {
+			if (!_is_inline()) {
+				put_space(m_base, capacity());
+			}
+		}
+
+		void _adopt(pointer new_base, pointer new_end, size_type new_capacity) {
+			_release();
+			m_base   = new_base;
+			m_end    = new_end;
+			m_finish = new_base + new_capacity;
+		}
+
+		void _extend(size_type new_capacity) {
+			pointer new_base = _allocate(new_capacity);
+			pointer new_end  = nullptr;
+			try {
+				new_end = _relocate_with_gap(m_base, m_end, m_end, new_base, 0);
+			}
+			catch (...) {
+				put_space(new_base, new_capacity);
+				throw;
+			}
+			_adopt(new_base, new_end, new_capacity);
+		}
+
+		size_type _next_capacity() const {
+			return growth_type::next(capacity(), (const allocator_type&) *this);
+		}
+
+		template <typename... _Args>
+		inner_iterator _realloc_emplace(difference_type offset, _Args&&... args) {
+			size_type new_capacity = _next_capacity();
+			pointer new_base = _allocate(new_capacity);
+			pointer new_end  = nullptr;
+
+			try {
+				construct(new_base + offset, std::forward<_Args>(args)...);
+			}
+			catch (...) {
+				put_space(new_base, new_capacity);
+				throw;
+			}
+
+			try {
+				new_end = _relocate_with_gap(m_base, m_base + offset, m_end, new_base, 1);
+			}
+			catch (...) {
+				destroy(new_base + offset);
+				put_space(new_base, new_capacity);
+				throw;
+			}
+
+			_adopt(new_base, new_end, new_capacity);
+			return m_base + offset;
+		}
+
+		template <typename... _Args>
+		inner_iterator _emplace(difference_type offset, _Args&&... args) {
+			if (m_end == m_finish) {
+				return _realloc_emplace(offset, std::forward<_Args>(args)...);
+			}
+
+			inner_iterator p = m_base + offset;
+			if (m_end == p) {
+				construct(p, std::forward<_Args>(args)...);
+			}
+			else {
+				/* args may refer to an element about to be shifted */
+				value_type tmp(std::forward<_Args>(args)...);
+				_insert_shifting(p, m_end, tmp);
+			}
+			++m_end;
+
+			return p;
+		}
+
+		/*
+		 * opens n slots at offset with a single shift of the tail, or a
+		 * single move to a new buffer, and has fill(p) construct
+		 * [p, p + n). On a move the new elements are built before the old
+		 * ones go, so fill may still read from the old buffer. A tail
+		 * whose moves may throw is not shifted, it moves as on growth.
+		 */
+		template <typename _Filler>
+		inner_iterator _insert_n(difference_type offset, size_type n, _Filler fill) {
+			if (0 == n) {
+				return m_base + offset;
+			}
+
+			bool room = n <= size_type(m_finish - m_end);
+			if (!room || (!_shifts_by_relocation<_Val>::value && m_base + offset != m_end)) {
+				size_type new_capacity = room ? capacity() : std::max(_next_capacity(), size() + n);
+				pointer new_base = _allocate(new_capacity);
+				pointer new_end  = nullptr;
+
+				try {
+					fill(new_base + offset);
+				}
+				catch (...) {
+					put_space(new_base, new_capacity);
+					throw;
+				}
+
+				try {
+					new_end = _relocate_with_gap(m_base, m_base + offset, m_end, new_base, n);
+				}
+				catch (...) {
+					destroy(new_base + offset, new_base + offset + n);
+					put_space(new_base, new_capacity);
+					throw;
+				}
+
+				_adopt(new_base, new_end, new_capacity);
+				return m_base + offset;
+			}
+
+			inner_iterator p = m_base + offset;
+			relocate_backward(p, m_end, m_end + n);
+			try {
+				fill(p);
+			}
+			catch (...) {
+				relocate(p + n, m_end + n, p);
+				throw;
+			}
+			m_end += n;
+
+			return p;
+		}
+
+		template <typename _Integer>
+		inner_iterator _insert_range(difference_type offset,
+		                             _Integer        n     ,
+		                             _Integer        val   ,
+		                             _true_type            ) {
+			return _insert_fill(offset, size_type(n), value_type(val));
+		}
+
+		template <typename _InputIterator>
+		inner_iterator _insert_range(difference_type offset,
+		                             _InputIterator  first ,
+		                             _InputIterator  last  ,
+		                             _false_type           ) {
+			typedef typename
+				_iterator_traits<_InputIterator>::iterator_category
+			category;
+
+			return _insert_range(offset, first, last, category());
+		}
+
+		template <typename _InputIterator>
+		inner_iterator _insert_range(difference_type offset,
+		                             _InputIterator  first ,
+		                             _InputIterator  last  ,
+		                             std::input_iterator_tag) {
+			/* length unknown up front: append, then rotate into place once */
+			size_type old_size = size();
+			while (first != last) {
+				emplace_back(*first);
+				++first;
+			}
+			std::rotate(m_base + offset, m_base + old_size, m_end);
+			return m_base + offset;
+		}
+
+		template <typename _ForwardIterator>
+		inner_iterator _insert_range(difference_type  offset,
+		                             _ForwardIterator first ,
+		                             _ForwardIterator last  ,
+		                             std::forward_iterator_tag) {
+			size_type n = std::distance(first, last);
+			return _insert_n(offset, n, [&](pointer p) {
+				tools::uninitialized_copy(first, last, p);
+			});
+		}
+
+		inner_iterator _insert_fill(difference_type offset, size_type n, const value_type& val) {
+			/* val may live in the tail that is about to shift */
+			value_type tmp(val);
+			return _insert_n(offset, n, [&](pointer p) {
+				construct(p, p + n, tmp);
+			});
+		}
+
+		/* takes other's elements, other is left empty */
+		void _steal(self_type& other) {
+			if (other._is_inline()) {
+				reserve(other.size());
+				m_end = tools::uninitialized_move(other.m_base, other.m_end, m_base);
+				other.clear();
+			}
+			else {
+				m_base   = other.m_base;
+				m_end    = other.m_end;
+				m_finish = other.m_finish;
+				other._reset_inline();
+			}
+		}
+
+		void _destroy() {
+			destroy(m_base, m_end);
+			_release();
+		}
+
+	public:
+		small_sequence() { _reset_inline(); }
+
+		explicit small_sequence(const _Allocator& alloc) : allocator_type(alloc) { _reset_inline(); }
+
+		small_sequence(const self_type& other) : allocator_type(other) {
+			_reset_inline();
+			reserve(other.size());
+			m_end = tools::uninitialized_copy(other.m_base, other.m_end, m_base);
+		}
+
+		small_sequence(self_type&& other)
+			noexcept(std::is_nothrow_move_constructible<_Val>::value) :
+			allocator_type(std::move((allocator_type&) other)) {
+			_reset_inline();
+			_steal(other);
+		}
+
+		template <typename _InputIterator>
+		small_sequence(_InputIterator    first,
+		               _InputIterator    last ,
+		               const _Allocator& alloc = _Allocator()) : allocator_type(alloc) {
+			_reset_inline();
+			while (first != last) {
+				this->push_back(*first);
+				++first;
+			}
+		}
+
+		~small_sequence() { _destroy(); }
+
+	public:
+		self_type& operator=(const self_type& other) {
+			if (this == &other) {
+				return *this;
+			}
+
+			clear();
+			reserve(other.size());
+			m_end = tools::uninitialized_copy(other.m_base, other.m_end, m_base);
+			return *this;
+		}
+
+		self_type& operator=(self_type&& other) {
+			if (this == &other) {
+				return *this;
+			}
+
+			_destroy();
+			_reset_inline();
+			(allocator_type&) *this = std::move((allocator_type&) other);
+			_steal(other);
+			return *this;
+		}
+
+		const_reference operator[](size_type index) const {
+			assert(index < size());
+			return *(m_base + index);
+		}
+
+		reference operator[](size_type index) {
+			return const_cast<reference>(
+				((const self_type*) this)->operator[](index)
+			);
+		}
+
+	public:
+		typedef _iterator_wrapper<inner_iterator, self_type>       iterator;
+		typedef _iterator_wrapper<const_inner_iterator, self_type> const_iterator;
+
+		typedef _reverse_iterator<iterator>       reverse_iterator;
+		typedef _reverse_iterator<const_iterator> const_reverse_iterator;
+
+	public:
+		_Allocator get_allocator() const { return allocator_type::get_allocator(); }
+
+		bool empty() const { return m_base == m_end; }
+		size_type size() const { return m_end - m_base; }
+		size_type max_size() const { return size_type(-1); }
+		size_type capacity() const { return m_finish - m_base; }
+		bool is_inline() const { return _is_inline(); }
+
+		static constexpr size_type inline_capacity() { return _N; }
+
+		reference at(size_type index) { return operator[](index); }
+		const_reference at(size_type index) const { return operator[](index); }
+
+		pointer data() { return const_cast<pointer>(((const self_type*) this)->data()); }
+		const_pointer data() const { return m_base; }
+
+		reference front() { return const_cast<reference>(((const self_type*) this)->front()); }
+		const_reference front() const { assert(!empty()); return *m_base; }
+
+		reference back() { return const_cast<reference>(((const self_type*) this)->back()); }
+		const_reference back() const { assert(!empty()); return *(m_end - 1); }
+
+		void clear() { destroy(m_base, m_end); m_end = m_base; }
+
+		void resize(size_type new_size) {
+			if (size() < new_size) {
+				reserve(new_size);
+				construct(m_end, m_base + new_size);
+			}
+			else {
+				destroy(m_base + new_size, m_end);
+			}
+			m_end = m_base + new_size;
+		}
+
+		void reserve(size_type new_capacity) {
+			if (capacity() < new_capacity) {
+				_extend(new_capacity);
+			}
+		}
+
+		void shrink_to_fit() {
+			if (_is_inline() || size() == capacity()) {
+				return;
+			}
+
+			if (size() <= _N) {
+				pointer old_base = m_base;
+				size_type old_capacity = capacity();
+				pointer new_end = _relocate_with_gap(m_base, m_end, m_end, _inline_base(), 0);
+				put_space(old_base, old_capacity);
+				m_base   = _inline_base();
+				m_end    = new_end;
+				m_finish = m_base + _N;
+				return;
+			}
+			_extend(size());
+		}
+
+		template <typename... _Args>
+		iterator emplace(const_iterator pos, _Args&&... args) {
+			return iterator(_emplace(pos - begin(), std::forward<_Args>(args)...));
+		}
+
+		template <typename... _Args>
+		void emplace_back(_Args&&... args) {
+			_emplace(m_end - m_base, std::forward<_Args>(args)...);
+		}
+
+		void push_back(const value_type& val) { insert(end(), val); }
+		void push_back(value_type&& val) { insert(end(), std::move(val)); }
+
+		void pop_back() { erase(--end()); }
+
+		iterator insert(const_iterator pos, const value_type& val) {
+			return iterator(_emplace(pos - begin(), val));
+		}
+
+		iterator insert(const_iterator pos, value_type&& val) {
+			return iterator(_emplace(pos - begin(), std::move(val)));
+		}
+
+		template <typename _InputIterator>
+		iterator insert(const_iterator pos, _InputIterator first, _InputIterator last) {
+			return iterator(_insert_range(
+				pos - begin(), first, last, _bool_type<std::is_integral<_InputIterator>::value>()
+			));
+		}
+
+		iterator insert(const_iterator pos, size_type n, const value_type& val) {
+			return iterator(_insert_fill(pos - begin(), n, val));
+		}
+
+		iterator erase(const_iterator pos) {
+			if (empty() || end() == pos) {
+				throw std::overflow_error("Invalid iterator or empty sequence.");
+			}
+
+			inner_iterator to_erase = m_base + (pos - begin());
+			m_end = _erase_shifting(to_erase, to_erase + 1, m_end);
+			return iterator(to_erase);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) {
+			inner_iterator p = m_base + (first - begin());
+			inner_iterator q = m_base + (last - begin());
+			if (p != q) {
+				m_end = _erase_shifting(p, q, m_end);
+			}
+			return iterator(p);
+		}
+
+		/* removes every element matching pred in one pass, returns how many went */
+		template <typename _Predicate>
+		size_type erase_if(_Predicate pred) {
+			inner_iterator old_end = m_end;
+			_erase_if_shifting(m_base, m_end, pred);
+			return old_end - m_end;
+		}
+
+		iterator begin() { return iterator(m_base); }
+		const_iterator begin() const { return const_iterator(m_base); }
+
+		iterator end() { return iterator(m_end); }
+		const_iterator end() const { return const_iterator(m_end); }
+
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+		void swap(self_type& other) {
+			if (this == &other) {
+				return;
+			}
+
+			if (!_is_inline() && !other._is_inline()) {
+				std::swap((allocator_type&) *this, (allocator_type&) other);
+				std::swap(m_base, other.m_base);
+				std::swap(m_end, other.m_end);
+				std::swap(m_finish, other.m_finish);
+				return;
+			}
+
+			self_type tmp(std::move(other));
+			other = std::move(*this);
+			*this = std::move(tmp);
+		}
+	};
+
+	template <typename _Val, size_t _N, typename _Allocator, typename _Growth>
+	inline void swap(small_sequence<_Val, _N, _Allocator, _Growth>& left,
+	                 small_sequence<_Val, _N, _Allocator, _Growth>& right) {
+		left.swap(right);
+	}
+}
+
+#endif //_SMALL_SEQUENCE_H_
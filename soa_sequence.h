@@ -0,0 +1,575 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _SOA_SEQUENCE_H_
+#define _SOA_SEQUENCE_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "memory.h"
+#include "sequence.h"
+
+namespace tools {
+
+	/* contiguous view of one column */
+	template <typename _T>
+	class column_span {
+	public:
+		typedef _T        value_type;
+		typedef _T*       iterator;
+		typedef size_t    size_type;
+
+	private:
+		_T*    m_data;
+		size_t m_size;
+
+	public:
+		column_span(_T* data, size_t size) : m_data(data), m_size(size) { }
+
+		_T* data() const { return m_data; }
+		size_t size() const { return m_size; }
+		bool empty() const { return 0 == m_size; }
+
+		_T& operator[](size_t index) const { assert(index < m_size); return m_data[index]; }
+
+		_T* begin() const { return m_data; }
+		_T* end() const { return m_data + m_size; }
+	};
+
+	/*
+	 * Structure of arrays: row i of soa_sequence<A, B, C> is spread over
+	 * three columns, A[i], B[i] and C[i]. All columns share one block and
+	 * grow together; each starts on a _column_align boundary so loops
+	 * over a single column vectorise cleanly. Rows are read and written
+	 * through tuples of references.
+	 */
+	template <
+		typename    _Allocator,
+		typename    _Growth,
+		typename... _Fields
+	>
+	class basic_soa_sequence : private standard_alloc<char, _Allocator> {
+		static_assert(0 < sizeof...(_Fields), "soa_sequence needs at least one field");
+
+	public:
+		enum { _column_align = 64, columns = sizeof...(_Fields) };
+
+		typedef std::tuple<_Fields...>        value_type;
+		typedef std::tuple<_Fields&...>       reference;
+		typedef std::tuple<const _Fields&...> const_reference;
+
+		typedef ptrdiff_t difference_type;
+		typedef size_t    size_type;
+
+		template <size_t _I>
+		using field_type = typename std::tuple_element<_I, value_type>::type;
+
+	protected:
+		typedef basic_soa_sequence<_Allocator, _Growth, _Fields...> self_type;
+		typedef standard_alloc<char, _Allocator>                    allocator_type;
+		typedef _Growth                                             growth_type;
+
+		typedef std::tuple<_Fields*...> columns_type;
+
+		template <size_t _I>
+		using _index = std::integral_constant<size_t, _I>;
+
+	private:
+		char*        m_block;
+		size_type    m_block_bytes;
+		columns_type m_columns;
+		size_type    m_size;
+		size_type    m_capacity;
+
+	private:
+		static size_t _align_up(size_t n, size_t align) {
+			return (n + align - 1) & ~(align - 1);
+		}
+
+		template <size_t _I>
+		static size_t _align_of() {
+			return alignof (field_type<_I>) < size_t(_column_align) ? size_t(_column_align) : alignof (field_type<_I>);
+		}
+
+		/* byte offset just past column _I - 1, measured from an aligned base */
+		static size_t _column_end(size_type, _index<0>) { return 0; }
+
+		template <size_t _I>
+		static size_t _column_end(size_type capacity, _index<_I>) {
+			return _column_offset(capacity, _index<_I - 1>()) + capacity * sizeof (field_type<_I - 1>);
+		}
+
+		template <size_t _I>
+		static size_t _column_offset(size_type capacity, _index<_I>) {
+			return _align_up(_column_end(capacity, _index<_I>()), _align_of<_I>());
+		}
+
+		/* bytes one row takes over all columns, padding aside */
+		static size_t _row_bytes(_index<0>) { return 0; }
+
+		template <size_t _I>
+		static size_t _row_bytes(_index<_I>) {
+			return _row_bytes(_index<_I - 1>()) + sizeof (field_type<_I - 1>);
+		}
+
+		static size_t _block_bytes(size_type capacity) {
+			/* slack to align the first column inside the block */
+			return _column_end(capacity, _index<columns>()) + _align_of<0>() - 1;
+		}
+
+		template <size_t... _Is>
+		static columns_type _place(char* block, size_type capacity, std::index_sequence<_Is...>) {
+			char* base = (char*) _align_up((uintptr_t) block, _align_of<0>());
+			return columns_type((field_type<_Is>*) (base + _column_offset(capacity, _index<_Is>()))...);
+		}
+
+		static columns_type _place(char* block, size_type capacity) {
+			return _place(block, capacity, std::index_sequence_for<_Fields...>());
+		}
+
+		/* destroys rows [first, last) */
+		static void _destroy_rows(columns_type&, size_type, size_type, _index<columns>) { }
+
+		template <size_t _I>
+		static void _destroy_rows(columns_type& cols, size_type first, size_type last, _index<_I>) {
+			destroy(std::get<_I>(cols) + first, std::get<_I>(cols) + last);
+			_destroy_rows(cols, first, last, _index<_I + 1>());
+		}
+
+		/* builds row index from the arguments, one per field; all or nothing */
+		template <typename _Args>
+		static void _construct_row(columns_type&, size_type, _Args&&, _index<columns>) { }
+
+		template <typename _Args, size_t _I>
+		static void _construct_row(columns_type& cols, size_type index, _Args&& args, _index<_I>) {
+			construct(std::get<_I>(cols) + index, std::get<_I>(std::forward<_Args>(args)));
+			try {
+				_construct_row(cols, index, std::forward<_Args>(args), _index<_I + 1>());
+			}
+			catch (...) {
+				destroy(std::get<_I>(cols) + index);
+				throw;
+			}
+		}
+
+		/* moves (or copies, when a move may throw) n rows, the source stays alive */
+		static void _transfer_rows(columns_type&, columns_type&, size_type, _index<columns>) { }
+
+		template <size_t _I>
+		static void _transfer_rows(columns_type& from, columns_type& to, size_type n, _index<_I>) {
+			tools::uninitialized_move_if_noexcept(std::get<_I>(from), std::get<_I>(from) + n, std::get<_I>(to));
+			try {
+				_transfer_rows(from, to, n, _index<_I + 1>());
+			}
+			catch (...) {
+				destroy(std::get<_I>(to), std::get<_I>(to) + n);
+				throw;
+			}
+		}
+
+		static void _copy_rows(const columns_type&, columns_type&, size_type, _index<columns>) { }
+
+		template <size_t _I>
+		static void _copy_rows(const columns_type& from, columns_type& to, size_type n, _index<_I>) {
+			const field_type<_I>* first = std::get<_I>(from);
+			tools::uninitialized_copy(first, first + n, std::get<_I>(to));
+			try {
+				_copy_rows(from, to, n, _index<_I + 1>());
+			}
+			catch (...) {
+				destroy(std::get<_I>(to), std::get<_I>(to) + n);
+				throw;
+			}
+		}
+
+		/*
+		 * moves rows [index + 1, size) down by one over the erased row.
+		 * Columns whose moves may throw shift by assignment first, so a
+		 * throw leaves every column with size live values; the others
+		 * relocate afterwards, when nothing can throw anymore.
+		 */
+		static void _close_gap(columns_type& cols, size_type index, size_type size) {
+			_assign_down(cols, index, size, _index<0>());
+			_settle_down(cols, index, size, _index<0>());
+		}
+
+		template <typename _T>
+		static void _assign_column(_T*, size_type, size_type, _true_type) { }
+
+		template <typename _T>
+		static void _assign_column(_T* column, size_type index, size_type size, _false_type) {
+			std::move(column + index + 1, column + size, column + index);
+		}
+
+		template <typename _T>
+		static void _settle_column(_T* column, size_type index, size_type size, _true_type) {
+			_erase_shifting(column + index, column + index + 1, column + size, _true_type());
+		}
+
+		template <typename _T>
+		static void _settle_column(_T* column, size_type, size_type size, _false_type) {
+			destroy(column + size - 1);
+		}
+
+		static void _assign_down(columns_type&, size_type, size_type, _index<columns>) { }
+
+		template <size_t _I>
+		static void _assign_down(columns_type& cols, size_type index, size_type size, _index<_I>) {
+			_assign_column(std::get<_I>(cols), index, size, _shifts_by_relocation<field_type<_I> >());
+			_assign_down(cols, index, size, _index<_I + 1>());
+		}
+
+		static void _settle_down(columns_type&, size_type, size_type, _index<columns>) { }
+
+		template <size_t _I>
+		static void _settle_down(columns_type& cols, size_type index, size_type size, _index<_I>) {
+			_settle_column(std::get<_I>(cols), index, size, _shifts_by_relocation<field_type<_I> >());
+			_settle_down(cols, index, size, _index<_I + 1>());
+		}
+
+		template <size_t... _Is>
+		reference _row(size_type index, std::index_sequence<_Is...>) const {
+			return reference(std::get<_Is>(m_columns)[index]...);
+		}
+
+		char* _allocate(size_type bytes) {
+			char* p = allocator_type::allocate(bytes);
+			if (nullptr == p && 0 != bytes) {
+				throw std::bad_alloc();
+			}
+			return p;
+		}
+
+		void _release() {
+			allocator_type::deallocate(m_block, m_block_bytes);
+			m_block       = nullptr;
+			m_block_bytes = 0;
+			m_columns     = columns_type();
+			m_capacity    = 0;
+		}
+
+		void _adopt(char* block, size_type bytes, columns_type& cols, size_type capacity) {
+			_destroy_rows(m_columns, 0, m_size, _index<0>());
+			allocator_type::deallocate(m_block, m_block_bytes);
+			m_block       = block;
+			m_block_bytes = bytes;
+			m_columns     = cols;
+			m_capacity    = capacity;
+		}
+
+		void _extend(size_type new_capacity) {
+			size_type bytes = _block_bytes(new_capacity);
+			char* block = _allocate(bytes);
+			columns_type cols = _place(block, new_capacity);
+			try {
+				_transfer_rows(m_columns, cols, m_size, _index<0>());
+			}
+			catch (...) {
+				allocator_type::deallocate(block, bytes);
+				throw;
+			}
+			_adopt(block, bytes, cols, new_capacity);
+		}
+
+		/*
+		 * Growth policies count rows while good_size counts bytes: the
+		 * block for the rows the policy picked is rounded up in bytes, and
+		 * the slack is turned back into whole rows.
+		 */
+		struct _row_sizer {
+			const allocator_type& alloc;
+
+			size_t good_size(size_t rows) const {
+				size_t bytes = alloc.good_size(_block_bytes(rows));
+				size_t grown = rows + (bytes - _block_bytes(rows)) / _row_bytes(_index<columns>());
+				while (rows < grown && bytes < _block_bytes(grown)) {
+					--grown;
+				}
+				return grown;
+			}
+		};
+
+		/* the new row is built first, args may refer into the old block */
+		template <typename _Args>
+		void _realloc_append(_Args&& args) {
+			_row_sizer sizer = { (const allocator_type&) *this };
+			size_type new_capacity = growth_type::next(m_capacity, sizer);
+			size_type bytes = _block_bytes(new_capacity);
+			char* block = _allocate(bytes);
+			columns_type cols = _place(block, new_capacity);
+
+			try {
+				_construct_row(cols, m_size, std::forward<_Args>(args), _index<0>());
+			}
+			catch (...) {
+				allocator_type::deallocate(block, bytes);
+				throw;
+			}
+
+			try {
+				_transfer_rows(m_columns, cols, m_size, _index<0>());
+			}
+			catch (...) {
+				_destroy_rows(cols, m_size, m_size + 1, _index<0>());
+				allocator_type::deallocate(block, bytes);
+				throw;
+			}
+
+			_adopt(block, bytes, cols, new_capacity);
+			++m_size;
+		}
+
+		template <typename _Args>
+		void _append(_Args&& args) {
+			if (m_size == m_capacity) {
+				_realloc_append(std::forward<_Args>(args));
+				return;
+			}
+			_construct_row(m_columns, m_size, std::forward<_Args>(args), _index<0>());
+			++m_size;
+		}
+
+		void _swap(self_type& other) {
+			std::swap((allocator_type&) *this, (allocator_type&) other);
+			std::swap(m_block, other.m_block);
+			std::swap(m_block_bytes, other.m_block_bytes);
+			std::swap(m_columns, other.m_columns);
+			std::swap(m_size, other.m_size);
+			std::swap(m_capacity, other.m_capacity);
+		}
+
+	public:
+		basic_soa_sequence() :
+			m_block(nullptr), m_block_bytes(0), m_size(0), m_capacity(0) { }
+
+		explicit basic_soa_sequence(const _Allocator& alloc) :
+			allocator_type(alloc), m_block(nullptr), m_block_bytes(0), m_size(0), m_capacity(0) { }
+
+		basic_soa_sequence(const self_type& other) :
+			allocator_type(other), m_block(nullptr), m_block_bytes(0), m_size(0), m_capacity(0) {
+			if (other.empty()) {
+				return;
+			}
+
+			m_block_bytes = _block_bytes(other.m_size);
+			m_block       = _allocate(m_block_bytes);
+			m_columns     = _place(m_block, other.m_size);
+			m_capacity    = other.m_size;
+			try {
+				_copy_rows(other.m_columns, m_columns, other.m_size, _index<0>());
+			}
+			catch (...) {
+				_release();
+				throw;
+			}
+			m_size = other.m_size;
+		}
+
+		basic_soa_sequence(self_type&& other) noexcept :
+			allocator_type(std::move((allocator_type&) other)),
+			m_block(other.m_block), m_block_bytes(other.m_block_bytes),
+			m_columns(other.m_columns), m_size(other.m_size), m_capacity(other.m_capacity) {
+			other.m_block       = nullptr;
+			other.m_block_bytes = 0;
+			other.m_columns     = columns_type();
+			other.m_size        = 0;
+			other.m_capacity    = 0;
+		}
+
+		~basic_soa_sequence() {
+			clear();
+			allocator_type::deallocate(m_block, m_block_bytes);
+		}
+
+	public:
+		self_type& operator=(const self_type& other) {
+			if (this != &other) {
+				self_type tmp(other);
+				_swap(tmp);
+			}
+			return *this;
+		}
+
+		self_type& operator=(self_type&& other) noexcept {
+			if (this != &other) {
+				self_type tmp(std::move(other));
+				_swap(tmp);
+			}
+			return *this;
+		}
+
+		reference operator[](size_type index) {
+			assert(index < m_size);
+			return _row(index, std::index_sequence_for<_Fields...>());
+		}
+
+		const_reference operator[](size_type index) const {
+			assert(index < m_size);
+			return _row(index, std::index_sequence_for<_Fields...>());
+		}
+
+	public:
+		/* random access over rows, dereferencing yields a tuple of references */
+		template <typename _Owner, typename _Reference>
+		class _row_iterator {
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef typename self_type::value_type  value_type;
+			typedef _Reference                      reference;
+			typedef void                            pointer;
+			typedef ptrdiff_t                       difference_type;
+
+		private:
+			_Owner*   m_owner;
+			size_type m_index;
+
+		public:
+			_row_iterator() : m_owner(nullptr), m_index(0) { }
+			_row_iterator(_Owner* owner, size_type index) : m_owner(owner), m_index(index) { }
+
+			template <typename _OtherOwner, typename _OtherReference>
+			_row_iterator(const _row_iterator<_OtherOwner, _OtherReference>& other) :
+				m_owner(other.owner()), m_index(other.index()) { }
+
+		public:
+			_Owner* owner() const { return m_owner; }
+			size_type index() const { return m_index; }
+
+			reference operator*() const { return (*m_owner)[m_index]; }
+			reference operator[](difference_type n) const { return (*m_owner)[m_index + n]; }
+
+			_row_iterator& operator++() { ++m_index; return *this; }
+			_row_iterator operator++(int) { _row_iterator tmp = *this; ++m_index; return tmp; }
+
+			_row_iterator& operator--() { --m_index; return *this; }
+			_row_iterator operator--(int) { _row_iterator tmp = *this; --m_index; return tmp; }
+
+			_row_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+			_row_iterator operator+(difference_type n) const { return _row_iterator(m_owner, m_index + n); }
+
+			_row_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+			_row_iterator operator-(difference_type n) const { return _row_iterator(m_owner, m_index - n); }
+
+			difference_type operator-(const _row_iterator& other) const {
+				return difference_type(m_index) - difference_type(other.m_index);
+			}
+
+			bool operator==(const _row_iterator& other) const { return m_index == other.m_index; }
+			bool operator!=(const _row_iterator& other) const { return m_index != other.m_index; }
+			bool operator<(const _row_iterator& other) const { return m_index < other.m_index; }
+			bool operator>(const _row_iterator& other) const { return m_index > other.m_index; }
+			bool operator<=(const _row_iterator& other) const { return m_index <= other.m_index; }
+			bool operator>=(const _row_iterator& other) const { return m_index >= other.m_index; }
+		};
+
+		typedef _row_iterator<self_type, reference>             iterator;
+		typedef _row_iterator<const self_type, const_reference> const_iterator;
+
+	public:
+		_Allocator get_allocator() const { return allocator_type::get_allocator(); }
+
+		bool empty() const { return 0 == m_size; }
+		size_type size() const { return m_size; }
+		size_type max_size() const { return size_type(-1); }
+		size_type capacity() const { return m_capacity; }
+
+		reference at(size_type index) { return operator[](index); }
+		const_reference at(size_type index) const { return operator[](index); }
+
+		reference front() { assert(!empty()); return operator[](0); }
+		const_reference front() const { assert(!empty()); return operator[](0); }
+
+		reference back() { assert(!empty()); return operator[](m_size - 1); }
+		const_reference back() const { assert(!empty()); return operator[](m_size - 1); }
+
+		/* column _I as one contiguous, _column_align aligned array */
+		template <size_t _I>
+		column_span<field_type<_I>> column() {
+			return column_span<field_type<_I>>(std::get<_I>(m_columns), m_size);
+		}
+
+		template <size_t _I>
+		column_span<const field_type<_I>> column() const {
+			return column_span<const field_type<_I>>(std::get<_I>(m_columns), m_size);
+		}
+
+		void clear() {
+			_destroy_rows(m_columns, 0, m_size, _index<0>());
+			m_size = 0;
+		}
+
+		void reserve(size_type new_capacity) {
+			if (m_capacity < new_capacity) {
+				_extend(new_capacity);
+			}
+		}
+
+		void shrink_to_fit() {
+			if (m_size == m_capacity) {
+				return;
+			}
+
+			if (empty()) {
+				_release();
+				return;
+			}
+			_extend(m_size);
+		}
+
+		void push_back(const _Fields&... fields) { _append(std::forward_as_tuple(fields...)); }
+
+		void push_back(const value_type& row) { _append(row); }
+		void push_back(value_type&& row) { _append(std::move(row)); }
+
+		/* one argument per field */
+		template <typename... _Args>
+		void emplace_back(_Args&&... args) {
+			static_assert(sizeof...(_Args) == columns, "emplace_back takes one argument per field");
+			_append(std::forward_as_tuple(std::forward<_Args>(args)...));
+		}
+
+		void pop_back() {
+			assert(!empty());
+			--m_size;
+			_destroy_rows(m_columns, m_size, m_size + 1, _index<0>());
+		}
+
+		iterator erase(const_iterator pos) {
+			size_type index = pos.index();
+			if (empty() || m_size <= index) {
+				throw std::overflow_error("Invalid iterator or empty sequence.");
+			}
+
+			_close_gap(m_columns, index, m_size);
+			--m_size;
+			return iterator(this, index);
+		}
+
+		iterator begin() { return iterator(this, 0); }
+		const_iterator begin() const { return const_iterator(this, 0); }
+
+		iterator end() { return iterator(this, m_size); }
+		const_iterator end() const { return const_iterator(this, m_size); }
+
+		void swap(self_type& other) { _swap(other); }
+	};
+
+	template <typename... _Fields>
+	using soa_sequence = basic_soa_sequence<std::allocator<char>, growth::doubling, _Fields...>;
+
+	template <typename _Allocator, typename _Growth, typename... _Fields>
+	inline void swap(basic_soa_sequence<_Allocator, _Growth, _Fields...>& left,
+	                 basic_soa_sequence<_Allocator, _Growth, _Fields...>& right) {
+		left.swap(right);
+	}
+}
+
+#endif //_SOA_SEQUENCE_H_
@@ -0,0 +1,617 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _SORT_H_
+#define _SORT_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "functor.h"
+#include "heap.h"
+#include "iterator.h"
+#include "memory.h"
+#include "type_base.h"
+
+namespace tools {
+
+	/*
+	 * Pattern-defeating quicksort (Orson Peters): introsort whose pivot is
+	 * a median of 3, or a ninther for large ranges. Partitions that swapped
+	 * nothing get a bounded insertion sort, so sorted stretches finish in
+	 * linear time. Runs of equal keys are split off whole. Unbalanced
+	 * partitions shuffle a few elements, and after log2(n) of them the
+	 * range goes to the heap sort of heap.h. A fully descending input is
+	 * reversed up front.
+	 *
+	 * For arithmetic values under a plain less/larger, the partition
+	 * records comparison results in offset blocks and swaps afterwards
+	 * (BlockQuicksort), which keeps mispredicted branches out of the loop.
+	 */
+
+	enum {
+		_sort_insertion_threshold = 24,
+		_sort_ninther_threshold   = 128,
+		_sort_partial_limit       = 8,
+		_sort_block_size          = 64,
+		_sort_cacheline           = 64
+	};
+
+	template <typename _T, typename _Comparator>
+	struct _sort_is_branchless : _false_type { };
+
+	template <typename _T>
+	struct _sort_is_branchless<_T, less<_T> > : _bool_type<std::is_arithmetic<_T>::value> { };
+
+	template <typename _T>
+	struct _sort_is_branchless<_T, larger<_T> > : _bool_type<std::is_arithmetic<_T>::value> { };
+
+	template <typename _T>
+	struct _sort_is_branchless<_T, std::less<_T> > : _bool_type<std::is_arithmetic<_T>::value> { };
+
+	template <typename _T>
+	struct _sort_is_branchless<_T, std::greater<_T> > : _bool_type<std::is_arithmetic<_T>::value> { };
+
+	template <typename _RandomAccessIterator, typename _Comparator>
+	inline void _insertion_sort(_RandomAccessIterator first,
+	                            _RandomAccessIterator last ,
+	                            _Comparator           comp ) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+
+		if (first == last) {
+			return;
+		}
+
+		for (_RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+			_RandomAccessIterator sift   = cur;
+			_RandomAccessIterator sift_1 = cur - 1;
+			if (comp(*sift, *sift_1)) {
+				value_type tmp(std::move(*sift));
+				do {
+					*sift-- = std::move(*sift_1);
+				} while (sift != first && comp(tmp, *--sift_1));
+				*sift = std::move(tmp);
+			}
+		}
+	}
+
+	/* *(first - 1) is not greater than any element of the range */
+	template <typename _RandomAccessIterator, typename _Comparator>
+	inline void _unguarded_insertion_sort(_RandomAccessIterator first,
+	                                      _RandomAccessIterator last ,
+	                                      _Comparator           comp ) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+
+		if (first == last) {
+			return;
+		}
+
+		for (_RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+			_RandomAccessIterator sift   = cur;
+			_RandomAccessIterator sift_1 = cur - 1;
+			if (comp(*sift, *sift_1)) {
+				value_type tmp(std::move(*sift));
+				do {
+					*sift-- = std::move(*sift_1);
+				} while (comp(tmp, *--sift_1));
+				*sift = std::move(tmp);
+			}
+		}
+	}
+
+	/* insertion sort that gives up, returning false, after moving too many elements */
+	template <typename _RandomAccessIterator, typename _Comparator>
+	inline bool _partial_insertion_sort(_RandomAccessIterator first,
+	                                    _RandomAccessIterator last ,
+	                                    _Comparator           comp ) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+
+		if (first == last) {
+			return true;
+		}
+
+		size_t moved = 0;
+		for (_RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+			_RandomAccessIterator sift   = cur;
+			_RandomAccessIterator sift_1 = cur - 1;
+			if (comp(*sift, *sift_1)) {
+				value_type tmp(std::move(*sift));
+				do {
+					*sift-- = std::move(*sift_1);
+				} while (sift != first && comp(tmp, *--sift_1));
+				*sift = std::move(tmp);
+				moved += cur - sift;
+			}
+			if (_sort_partial_limit < moved) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template <typename _RandomAccessIterator, typename _Comparator>
+	inline void _sort2(_RandomAccessIterator a, _RandomAccessIterator b, _Comparator comp) {
+		if (comp(*b, *a)) {
+			std::iter_swap(a, b);
+		}
+	}
+
+	template <typename _RandomAccessIterator, typename _Comparator>
+	inline void _sort3(_RandomAccessIterator a,
+	                   _RandomAccessIterator b,
+	                   _RandomAccessIterator c,
+	                   _Comparator           comp) {
+		_sort2(a, b, comp);
+		_sort2(b, c, comp);
+		_sort2(a, b, comp);
+	}
+
+	inline unsigned char* _sort_align_cacheline(unsigned char* p) {
+		uintptr_t address = uintptr_t(p);
+		return (unsigned char*) ((address + _sort_cacheline - 1) & ~uintptr_t(_sort_cacheline - 1));
+	}
+
+	/* swaps the num pairs first + offsets_l[i], last - offsets_r[i] */
+	template <typename _RandomAccessIterator>
+	inline void _swap_offsets(_RandomAccessIterator first    ,
+	                          _RandomAccessIterator last     ,
+	                          const unsigned char*  offsets_l,
+	                          const unsigned char*  offsets_r,
+	                          size_t                num      ,
+	                          bool                  use_swaps) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+
+		if (use_swaps) {
+			/* the two counts match, the cyclic version would break the partition */
+			for (size_t i = 0; i < num; ++i) {
+				std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+			}
+		}
+		else if (0 < num) {
+			_RandomAccessIterator l = first + offsets_l[0];
+			_RandomAccessIterator r = last - offsets_r[0];
+			value_type tmp(std::move(*l));
+			*l = std::move(*r);
+			for (size_t i = 1; i < num; ++i) {
+				l = first + offsets_l[i];
+				*r = std::move(*l);
+				r = last - offsets_r[i];
+				*l = std::move(*r);
+			}
+			*r = std::move(tmp);
+		}
+	}
+
+	/*
+	 * Partitions around *first: [first, pivot) < pivot <= (pivot, last).
+	 * Returns the pivot's place and whether the range was partitioned
+	 * already. *(last - 1) or an element before first stops the scans.
+	 */
+	template <typename _RandomAccessIterator, typename _Comparator>
+	inline std::pair<_RandomAccessIterator, bool> _partition_right(_RandomAccessIterator begin,
+	                                                               _RandomAccessIterator end  ,
+	                                                               _Comparator           comp ,
+	                                                               _false_type) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+
+		value_type pivot(std::move(*begin));
+		_RandomAccessIterator first = begin;
+		_RandomAccessIterator last  = end;
+
+		while (comp(*++first, pivot));
+		if (first - 1 == begin) {
+			while (first < last && !comp(*--last, pivot));
+		}
+		else {
+			while (!comp(*--last, pivot));
+		}
+
+		bool already_partitioned = first >= last;
+		while (first < last) {
+			std::iter_swap(first, last);
+			while (comp(*++first, pivot));
+			while (!comp(*--last, pivot));
+		}
+
+		_RandomAccessIterator pivot_pos = first - 1;
+		*begin     = std::move(*pivot_pos);
+		*pivot_pos = std::move(pivot);
+		return std::make_pair(pivot_pos, already_partitioned);
+	}
+
+	template <typename _RandomAccessIterator, typename _Comparator>
+	inline std::pair<_RandomAccessIterator, bool> _partition_right(_RandomAccessIterator begin,
+	                                                               _RandomAccessIterator end  ,
+	                                                               _Comparator           comp ,
+	                                                               _true_type) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+
+		value_type pivot(std::move(*begin));
+		_RandomAccessIterator first = begin;
+		_RandomAccessIterator last  = end;
+
+		while (comp(*++first, pivot));
+		if (first - 1 == begin) {
+			while (first < last && !comp(*--last, pivot));
+		}
+		else {
+			while (!comp(*--last, pivot));
+		}
+
+		bool already_partitioned = first >= last;
+		if (!already_partitioned) {
+			std::iter_swap(first, last);
+			++first;
+
+			/* offsets of misplaced elements, from the left and from the right base */
+			unsigned char storage_l[_sort_block_size + _sort_cacheline];
+			unsigned char storage_r[_sort_block_size + _sort_cacheline];
+			unsigned char* offsets_l = _sort_align_cacheline(storage_l);
+			unsigned char* offsets_r = _sort_align_cacheline(storage_r);
+
+			_RandomAccessIterator base_l = first;
+			_RandomAccessIterator base_r = last;
+			size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+			while (first < last) {
+				size_t unknown = last - first;
+				size_t split_l = 0 == num_l ? (0 == num_r ? unknown / 2 : unknown) : 0;
+				size_t split_r = 0 == num_r ? unknown - split_l : 0;
+
+				if (_sort_block_size <= split_l) {
+					for (size_t i = 0; i < _sort_block_size; ++i) {
+						offsets_l[num_l] = (unsigned char) i;
+						num_l += !comp(*first, pivot);
+						++first;
+					}
+				}
+				else {
+					for (size_t i = 0; i < split_l; ++i) {
+						offsets_l[num_l] = (unsigned char) i;
+						num_l += !comp(*first, pivot);
+						++first;
+					}
+				}
+
+				if (_sort_block_size <= split_r) {
+					for (size_t i = 0; i < _sort_block_size;) {
+						offsets_r[num_r] = (unsigned char) ++i;
+						num_r += comp(*--last, pivot);
+					}
+				}
+				else {
+					for (size_t i = 0; i < split_r;) {
+						offsets_r[num_r] = (unsigned char) ++i;
+						num_r += comp(*--last, pivot);
+					}
+				}
+
+				size_t num = std::min(num_l, num_r);
+				_swap_offsets(base_l, base_r, offsets_l + start_l, offsets_r + start_r, num, num_l == num_r);
+				num_l -= num;
+				num_r -= num;
+				start_l += num;
+				start_r += num;
+
+				if (0 == num_l) {
+					start_l = 0;
+					base_l  = first;
+				}
+				if (0 == num_r) {
+					start_r = 0;
+					base_r  = last;
+				}
+			}
+
+			/* one side may have misplaced elements left over, they go to the middle */
+			if (0 != num_l) {
+				offsets_l += start_l;
+				while (0 != num_l--) {
+					std::iter_swap(base_l + offsets_l[num_l], --last);
+				}
+				first = last;
+			}
+			if (0 != num_r) {
+				offsets_r += start_r;
+				while (0 != num_r--) {
+					std::iter_swap(base_r - offsets_r[num_r], first);
+					++first;
+				}
+				last = first;
+			}
+		}
+
+		_RandomAccessIterator pivot_pos = first - 1;
+		*begin     = std::move(*pivot_pos);
+		*pivot_pos = std::move(pivot);
+		return std::make_pair(pivot_pos, already_partitioned);
+	}
+
+	/* [first, pivot] <= pivot < (pivot, last), for a pivot equal to the element before first */
+	template <typename _RandomAccessIterator, typename _Comparator>
+	inline _RandomAccessIterator _partition_left(_RandomAccessIterator begin,
+	                                             _RandomAccessIterator end  ,
+	                                             _Comparator           comp ) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+
+		value_type pivot(std::move(*begin));
+		_RandomAccessIterator first = begin;
+		_RandomAccessIterator last  = end;
+
+		while (comp(pivot, *--last));
+		if (last + 1 == end) {
+			while (first < last && !comp(pivot, *++first));
+		}
+		else {
+			while (!comp(pivot, *++first));
+		}
+
+		while (first < last) {
+			std::iter_swap(first, last);
+			while (comp(pivot, *--last));
+			while (!comp(pivot, *++first));
+		}
+
+		_RandomAccessIterator pivot_pos = last;
+		*begin     = std::move(*pivot_pos);
+		*pivot_pos = std::move(pivot);
+		return pivot_pos;
+	}
+
+	template <typename _RandomAccessIterator, typename _Comparator, typename _Branchless>
+	void _pdq_sort(_RandomAccessIterator begin      ,
+	               _RandomAccessIterator end        ,
+	               _Comparator           comp       ,
+	               int                   bad_allowed,
+	               bool                  leftmost   ,
+	               _Branchless           branchless ) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::difference_type difference_type;
+
+		while (true) {
+			difference_type size = end - begin;
+			if (size < _sort_insertion_threshold) {
+				if (leftmost) {
+					_insertion_sort(begin, end, comp);
+				}
+				else {
+					_unguarded_insertion_sort(begin, end, comp);
+				}
+				return;
+			}
+
+			difference_type half = size / 2;
+			if (_sort_ninther_threshold < size) {
+				_sort3(begin, begin + half, end - 1, comp);
+				_sort3(begin + 1, begin + (half - 1), end - 2, comp);
+				_sort3(begin + 2, begin + (half + 1), end - 3, comp);
+				_sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+				std::iter_swap(begin, begin + half);
+			}
+			else {
+				_sort3(begin + half, begin, end - 1, comp);
+			}
+
+			/* the pivot equals the element before the range: everything equal to it goes left at once */
+			if (!leftmost && !comp(*(begin - 1), *begin)) {
+				begin = _partition_left(begin, end, comp) + 1;
+				continue;
+			}
+
+			std::pair<_RandomAccessIterator, bool> part = _partition_right(begin, end, comp, branchless);
+			_RandomAccessIterator pivot_pos = part.first;
+
+			difference_type size_l = pivot_pos - begin;
+			difference_type size_r = end - (pivot_pos + 1);
+
+			if (size_l < size / 8 || size_r < size / 8) {
+				if (0 == --bad_allowed) {
+					_make_heap(begin, end, comp);
+					_heap_sort(begin, end, comp);
+					return;
+				}
+
+				if (_sort_insertion_threshold <= size_l) {
+					std::iter_swap(begin, begin + size_l / 4);
+					std::iter_swap(pivot_pos - 1, pivot_pos - size_l / 4);
+					if (_sort_ninther_threshold < size_l) {
+						std::iter_swap(begin + 1, begin + (size_l / 4 + 1));
+						std::iter_swap(begin + 2, begin + (size_l / 4 + 2));
+						std::iter_swap(pivot_pos - 2, pivot_pos - (size_l / 4 + 1));
+						std::iter_swap(pivot_pos - 3, pivot_pos - (size_l / 4 + 2));
+					}
+				}
+
+				if (_sort_insertion_threshold <= size_r) {
+					std::iter_swap(pivot_pos + 1, pivot_pos + (1 + size_r / 4));
+					std::iter_swap(end - 1, end - size_r / 4);
+					if (_sort_ninther_threshold < size_r) {
+						std::iter_swap(pivot_pos + 2, pivot_pos + (2 + size_r / 4));
+						std::iter_swap(pivot_pos + 3, pivot_pos + (3 + size_r / 4));
+						std::iter_swap(end - 2, end - (1 + size_r / 4));
+						std::iter_swap(end - 3, end - (2 + size_r / 4));
+					}
+				}
+			}
+			else if (part.second &&
+			         _partial_insertion_sort(begin, pivot_pos, comp) &&
+			         _partial_insertion_sort(pivot_pos + 1, end, comp)) {
+				return;
+			}
+
+			_pdq_sort(begin, pivot_pos, comp, bad_allowed, leftmost, branchless);
+			begin    = pivot_pos + 1;
+			leftmost = false;
+		}
+	}
+
+	/* reverses [first, last) when it is non-increasing, returns whether it did */
+	template <typename _RandomAccessIterator, typename _Comparator>
+	inline bool _reverse_if_descending(_RandomAccessIterator first,
+	                                   _RandomAccessIterator last ,
+	                                   _Comparator           comp ) {
+		if (last - first < 2 || !comp(*(first + 1), *first)) {
+			return false;
+		}
+		for (_RandomAccessIterator cur = first + 1; cur + 1 != last; ++cur) {
+			if (comp(*cur, *(cur + 1))) {
+				return false;
+			}
+		}
+		std::reverse(first, last);
+		return true;
+	}
+
+	template <typename _RandomAccessIterator, typename _Comparator>
+	void sort(_RandomAccessIterator first, _RandomAccessIterator last, _Comparator comp) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+
+		if (last - first < 2 || _reverse_if_descending(first, last, comp)) {
+			return;
+		}
+
+		int bad_allowed = 64 - __builtin_clzll((unsigned long long) (last - first));
+		_pdq_sort(first, last, comp, bad_allowed, true,
+		          _sort_is_branchless<value_type, _Comparator>());
+	}
+
+	template <typename _RandomAccessIterator>
+	inline void sort(_RandomAccessIterator first, _RandomAccessIterator last) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+		tools::sort(first, last, less<value_type>());
+	}
+
+	/*
+	 * LSD radix sort on a key taken from each value, stable. Keys may be
+	 * integers of any width or float/double; they are mapped to unsigned
+	 * integers of the same order and sorted a byte per pass, skipping
+	 * bytes that are the same in every key. Values move between the range
+	 * and a buffer of the same size, so moving them must not throw.
+	 * Short ranges get an insertion sort, which is stable as well.
+	 */
+
+	template <typename _Key, typename = void>
+	struct _radix_key;
+
+	template <typename _Key>
+	struct _radix_key<_Key, typename std::enable_if<std::is_integral<_Key>::value>::type> {
+		typedef typename std::make_unsigned<_Key>::type bits_type;
+
+		static bits_type encode(_Key key) {
+			const bits_type sign = std::is_signed<_Key>::value ? bits_type(1) << (sizeof (_Key) * 8 - 1) : 0;
+			return bits_type(key) ^ sign;
+		}
+	};
+
+	template <typename _Key>
+	struct _radix_key<_Key, typename std::enable_if<std::is_floating_point<_Key>::value>::type> {
+		typedef typename std::conditional<sizeof (_Key) == 4, uint32_t, uint64_t>::type bits_type;
+
+		/* negatives flip entirely, positives get the sign bit set */
+		static bits_type encode(_Key key) {
+			static_assert(sizeof (_Key) == sizeof (bits_type), "radix_sort takes float and double keys");
+			const bits_type sign = bits_type(1) << (sizeof (bits_type) * 8 - 1);
+			bits_type bits;
+			memcpy(&bits, &key, sizeof (bits));
+			return 0 != (bits & sign) ? ~bits : bits | sign;
+		}
+	};
+
+	template <typename _Value, typename _KeyExtractor>
+	struct _radix_less {
+		typedef typename std::decay<
+			decltype(std::declval<_KeyExtractor&>()(std::declval<const _Value&>()))
+		>::type key_type;
+
+		_KeyExtractor key;
+
+		bool operator()(const _Value& left, const _Value& right) const {
+			return _radix_key<key_type>::encode(key(left)) < _radix_key<key_type>::encode(key(right));
+		}
+	};
+
+	enum { _radix_threshold = 64 };
+
+	template <typename _RandomAccessIterator, typename _KeyExtractor>
+	void radix_sort(_RandomAccessIterator first, _RandomAccessIterator last, _KeyExtractor key) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+		typedef _radix_less<value_type, _KeyExtractor>                       less_type;
+		typedef _radix_key<typename less_type::key_type>                    key_traits;
+		typedef typename key_traits::bits_type                               bits_type;
+
+		static_assert(std::is_nothrow_move_constructible<value_type>::value &&
+		              std::is_nothrow_move_assignable<value_type>::value,
+		              "radix_sort needs non-throwing moves");
+
+		enum { passes = sizeof (bits_type) };
+
+		const size_t length = last - first;
+		if (length < _radix_threshold) {
+			less_type comp = { key };
+			_insertion_sort(first, last, comp);
+			return;
+		}
+
+		size_t counts[passes][256];
+		memset(counts, 0, sizeof (counts));
+		for (_RandomAccessIterator cur = first; cur != last; ++cur) {
+			bits_type bits = key_traits::encode(key(*cur));
+			for (size_t p = 0; p < passes; ++p) {
+				++counts[p][(bits >> (p * 8)) & 0xff];
+			}
+		}
+
+		value_type* buffer = (value_type*) ::operator new(length * sizeof (value_type));
+		tools::uninitialized_move(first, last, buffer);
+
+		/* the values are in buffer now, every pass moves them to the other side */
+		bool in_buffer = true;
+		for (size_t p = 0; p < passes; ++p) {
+			size_t* count = counts[p];
+			if (count + 256 != std::find(count, count + 256, length)) {
+				continue;
+			}
+
+			size_t offsets[256];
+			size_t sum = 0;
+			for (size_t b = 0; b < 256; ++b) {
+				offsets[b] = sum;
+				sum += count[b];
+			}
+
+			if (in_buffer) {
+				for (size_t i = 0; i < length; ++i) {
+					size_t b = (key_traits::encode(key(buffer[i])) >> (p * 8)) & 0xff;
+					first[offsets[b]++] = std::move(buffer[i]);
+				}
+			}
+			else {
+				for (size_t i = 0; i < length; ++i) {
+					size_t b = (key_traits::encode(key(first[i])) >> (p * 8)) & 0xff;
+					buffer[offsets[b]++] = std::move(first[i]);
+				}
+			}
+			in_buffer = !in_buffer;
+		}
+
+		if (in_buffer) {
+			std::move(buffer, buffer + length, first);
+		}
+		destroy(buffer, buffer + length);
+		::operator delete(buffer);
+	}
+
+	template <typename _RandomAccessIterator>
+	inline void radix_sort(_RandomAccessIterator first, _RandomAccessIterator last) {
+		typedef typename _iterator_traits<_RandomAccessIterator>::value_type value_type;
+		radix_sort(first, last, self<value_type>());
+	}
+}
+
+#endif //_SORT_H_
@@ -7,13 +7,9 @@
 
 #include <utility>
 
-namespace tools {
+#include "sequence.h"
 
-	template <
-		typename _Val,
-		typename _Allocator
-	>
-	class sequence;
+namespace tools {
 
 	template <typename _Val, typename _Container = sequence<_Val>>
 	class stack {
@@ -43,6 +39,7 @@ namespace tools {
 
 		void pop() { m_container.pop_back(); }
 		void push(const value_type& val) { return m_container.push_back(val); }
+		void push(value_type&& val) { return m_container.push_back(std::move(val)); }
 
 		template <typename... _Args>
 		void emplace(_Args&&... args) { m_container.emplace_back(std::forward<_Args>(args)...); }
@@ -0,0 +1,1498 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ *
+ * usage: tests [name...], runs every test when no name is given and
+ * exits non-zero when a check fails
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "algorithm.h"
+#include "bit_sequence.h"
+#include "aligned_adaptor.h"
+#include "alloc_stats.h"
+#include "arena.h"
+#include "deque.h"
+#include "double_list.h"
+#include "flat_hash_map.h"
+#include "flat_map.h"
+#include "heap.h"
+#include "huge_page_alloc.h"
+#include "memory_resource.h"
+#include "mmap_sequence.h"
+#include "mremap_alloc.h"
+#include "packed_int_sequence.h"
+#include "parallel.h"
+#include "persistent_vector.h"
+#include "queue.h"
+#include "pool_alloc.h"
+#include "rb_tree.h"
+#include "sequence.h"
+#include "single_list.h"
+#include "slot_map.h"
+#include "small_sequence.h"
+#include "soa_sequence.h"
+#include "sort.h"
+#include "thread_cache_alloc.h"
+
+namespace {
+
+	int failures = 0;
+
+	void expect(bool ok, const char* what, const char* file, int line) {
+		if (!ok) {
+			++failures;
+			std::cerr << file << ":" << line << ": check failed: " << what << std::endl;
+		}
+	}
+
+#define EXPECT(cond) expect((cond), #cond, __FILE__, __LINE__)
+
+	void pool_alloc_lists() {
+		typedef tools::double_list<std::string, tools::pool_alloc> list_type;
+
+		list_type list;
+		for (int i = 0; i < 1000; ++i) {
+			list.push_back(std::to_string(i));
+		}
+
+		list_type copy(list);
+		copy.push_back("extra");
+		EXPECT(1000 == list.size() && 1001 == copy.size());
+		EXPECT("999" == list.back() && "extra" == copy.back());
+
+		copy = list;
+		copy = copy;
+		EXPECT(1000 == copy.size() && "0" == copy.front());
+
+		/* copies own their nodes, so both lists tear down on their own */
+		typedef tools::single_list<std::string, tools::pool_alloc> slist_type;
+
+		slist_type slist(list.begin(), list.end());
+		{
+			slist_type scopy(slist);
+			scopy.push_front("first");
+			scopy.push_back("last");
+			EXPECT(1000 == slist.size() && 1002 == scopy.size());
+			EXPECT("0" == slist.front() && "first" == scopy.front() && "last" == scopy.back());
+
+			slist_type assigned;
+			assigned.push_back("gone");
+			assigned = scopy;
+			assigned = assigned;
+			scopy.clear();
+			EXPECT(1002 == assigned.size() && "last" == assigned.back() && scopy.empty());
+		}
+		EXPECT(1000 == slist.size() && "999" == slist.back());
+
+		typedef tools::_rb_tree<
+			int, int, tools::self<int>, tools::less<int>, tools::pool_alloc
+		> tree_type;
+
+		tree_type tree;
+		for (int i = 0; i < 1000; ++i) {
+			tree.insert_unique((i * 7919) % 1000);
+		}
+		EXPECT(1000 == tree.size() && tree.end() != tree.find(500));
+
+		/* requests above the largest class bypass the slabs */
+		void* big = tools::pool_alloc::allocate(4096);
+		tools::pool_alloc::deallocate(big, 4096);
+		EXPECT(48 == tools::pool_alloc::good_size(40));
+	}
+
+	/* containers on different threads share the size classes */
+	void pool_alloc_threads() {
+		auto churn = [] {
+			for (int r = 0; r < 20; ++r) {
+				tools::double_list<int, tools::pool_alloc> list;
+				for (int i = 0; i < 2000; ++i) {
+					list.push_back(i);
+				}
+			}
+		};
+
+		std::thread first(churn), second(churn);
+		first.join();
+		second.join();
+	}
+
+	void arena_region() {
+		tools::arena region(256);
+		char* first  = (char*) region.allocate(10);
+		char* second = (char*) region.allocate(1);
+		EXPECT(0 == (uintptr_t) first % tools::arena::_align);
+		EXPECT(second == first + 16);
+
+		/* larger than the chunk left, takes a chunk of its own */
+		void* big = region.allocate(4096);
+		EXPECT(nullptr != big && 4096 < region.capacity());
+
+		region.release();
+		EXPECT(0 == region.capacity());
+
+		tools::single_list<std::string, tools::arena_alloc> list((tools::arena_alloc(region)));
+		for (int i = 0; i < 100; ++i) {
+			list.push_front("a string too long for the small string buffer " + std::to_string(i));
+		}
+		EXPECT(100 == list.size() && list.get_allocator().region() == &region);
+	}
+
+	/* an arena_alloc stays on the arena of the scope it was built in */
+	void arena_scopes() {
+		bool threw = false;
+		try {
+			tools::arena_alloc unbound;
+		}
+		catch (std::bad_alloc&) {
+			threw = true;
+		}
+		EXPECT(threw);
+
+		tools::arena outer;
+		tools::arena::scope outer_scope(outer);
+		tools::single_list<std::string, tools::arena_alloc> list;
+		{
+			tools::arena inner;
+			tools::arena::scope inner_scope(inner);
+			for (int i = 0; i < 100; ++i) {
+				list.push_front("a string too long for the small string buffer " + std::to_string(i));
+			}
+			inner.release();
+		}
+
+		size_t length = 0;
+		for (const std::string& s : list) {
+			length += s.size();
+		}
+		EXPECT(100 == list.size() && 0 != length && list.get_allocator().region() == &outer);
+	}
+
+	void memory_resources() {
+		char buffer[256];
+		tools::monotonic_buffer_resource resource(buffer, sizeof buffer);
+		void* first = resource.allocate(64);
+		EXPECT(buffer <= (char*) first && (char*) first < buffer + sizeof buffer);
+
+		tools::sequence<int, tools::polymorphic_alloc> values((tools::polymorphic_alloc(&resource)));
+		for (int i = 0; i < 1000; ++i) {
+			values.push_back(i);
+		}
+		EXPECT(1000 == values.size() && 999 == values.back());
+		EXPECT(values.get_allocator() == tools::polymorphic_alloc(&resource));
+		EXPECT(tools::polymorphic_alloc() == tools::polymorphic_alloc(tools::new_delete_resource()));
+
+		tools::memory_resource* previous = tools::set_default_resource(&resource);
+		EXPECT(&resource == tools::polymorphic_alloc().resource());
+		tools::set_default_resource(previous);
+	}
+
+	/* blocks handed from one thread to another go back through the depot */
+	void thread_cache_handoff() {
+		std::vector<void*> blocks;
+		std::thread producer([&blocks] {
+			for (int i = 0; i < 5000; ++i) {
+				blocks.push_back(tools::thread_cache_alloc::allocate(32));
+			}
+		});
+		producer.join();
+
+		for (void* p : blocks) {
+			tools::thread_cache_alloc::deallocate(p, 32);
+		}
+
+		auto churn = [] {
+			for (int r = 0; r < 20; ++r) {
+				tools::double_list<int, tools::thread_cache_alloc> list;
+				for (int i = 0; i < 2000; ++i) {
+					list.push_back(i);
+				}
+			}
+		};
+		std::thread first(churn), second(churn);
+		first.join();
+		second.join();
+
+		void* big = tools::thread_cache_alloc::allocate(4096);
+		tools::thread_cache_alloc::deallocate(big, 4096);
+		EXPECT(32 == tools::thread_cache_alloc::good_size(17));
+	}
+
+	struct stats_sequence_tag { };
+	struct stats_list_tag { };
+
+	tools::alloc_stats_snapshot stats_of_sequences() {
+		return tools::alloc_stats_policy::record<stats_sequence_tag>().snapshot();
+	}
+
+	tools::alloc_stats_snapshot stats_of_lists() {
+		return tools::alloc_stats_policy::record<stats_list_tag>().snapshot();
+	}
+
+	/* each tagged container counts into its own record, untagged ones count nowhere */
+	void alloc_stats_counts() {
+		tools::alloc_stats_snapshot before = stats_of_sequences();
+		tools::alloc_stats_snapshot during, list_during;
+		{
+			tools::sequence<int, tools::alloc_stats_adaptor<stats_sequence_tag> > values;
+			tools::sequence<int> plain;
+			for (int i = 0; i < 100; ++i) {
+				values.push_back(i);
+				plain.push_back(i);
+			}
+			during = stats_of_sequences();
+
+			/* capacities 1, 2, 4, ..., 128: the last grow held 256 and 512 bytes at once */
+			EXPECT(8 == during.allocations - before.allocations && 7 == during.deallocations - before.deallocations);
+			EXPECT(512 == during.live_bytes - before.live_bytes && 768 <= during.peak_bytes);
+			EXPECT(1 == during.histogram[9] - before.histogram[9] && 1 == during.histogram[2] - before.histogram[2]);
+
+			tools::double_list<int, tools::alloc_stats_adaptor<stats_list_tag> > list;
+			for (int i = 0; i < 10; ++i) {
+				list.push_back(i);
+			}
+			list_during = stats_of_lists();
+			EXPECT(10 <= list_during.allocations && 0 != list_during.live_bytes);
+			EXPECT(during.allocations == stats_of_sequences().allocations);
+		}
+		tools::alloc_stats_snapshot after = stats_of_sequences();
+		tools::alloc_stats_snapshot list_after = stats_of_lists();
+		EXPECT(8 == after.deallocations - before.deallocations && before.live_bytes == after.live_bytes);
+		EXPECT(list_after.allocations == list_after.deallocations && 0 == list_after.live_bytes);
+
+		/* the adaptor keeps what the upstream can do */
+		EXPECT((tools::_alloc_can_reallocate<tools::alloc_stats_adaptor<stats_sequence_tag, tools::mremap_alloc> >::value));
+		tools::alloc_stats_adaptor<stats_sequence_tag, tools::pool_alloc> pooled;
+		EXPECT(tools::pool_alloc::good_size(20) == pooled.good_size(20));
+
+		size_t listed = 0;
+		for (const tools::alloc_stats_snapshot& snapshot : tools::alloc_stats()) {
+			listed += 0 == strcmp(snapshot.name, during.name) || 0 == strcmp(snapshot.name, list_during.name);
+		}
+		EXPECT(2 == listed);
+	}
+
+	/* live instances of counted, and how many copies and moves are left before one throws */
+	struct counts {
+		static int live;
+		static int copies;
+		static int moves;
+		static int throw_in;
+
+		static void reset(int n = 0) { copies = 0; moves = 0; throw_in = n; }
+
+		static void tick() {
+			if (0 != throw_in && 0 == --throw_in) {
+				throw std::runtime_error("counted");
+			}
+		}
+	};
+
+	int counts::live     = 0;
+	int counts::copies   = 0;
+	int counts::moves    = 0;
+	int counts::throw_in = 0;
+
+	/* copies and assignments may throw; moves too unless _NothrowMove */
+	template <bool _NothrowMove>
+	struct counted {
+		int value;
+
+		explicit counted(int v = 0) : value(v) { ++counts::live; }
+		counted(const counted& other) : value(other.value) { counts::tick(); ++counts::copies; ++counts::live; }
+		counted(counted&& other) noexcept(_NothrowMove) : value(other.value) {
+			if (!_NothrowMove) {
+				counts::tick();
+			}
+			++counts::moves;
+			++counts::live;
+		}
+		~counted() { --counts::live; }
+
+		counted& operator=(const counted& other) { counts::tick(); ++counts::copies; value = other.value; return *this; }
+		counted& operator=(counted&& other) { counts::tick(); ++counts::moves; value = other.value; return *this; }
+	};
+
+	template <typename _T>
+	bool values_are(const _T* first, const _T* last, int start) {
+		for (; first != last; ++first, ++start) {
+			if (start != first->value) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template <typename _Sequence>
+	bool values_are(const _Sequence& values, std::initializer_list<int> expected) {
+		return values.size() == expected.size() &&
+		       std::equal(expected.begin(), expected.end(), values.begin(),
+		                  [](int v, const typename _Sequence::value_type& c) { return v == c.value; });
+	}
+
+	/* the trait-dispatched helpers leave no instance behind, also when a copy throws */
+	void memory_helpers() {
+		typedef counted<true>  nothrow_type;
+		typedef counted<false> throwing_type;
+
+		std::allocator<nothrow_type> alloc;
+		nothrow_type* raw = alloc.allocate(16);
+		nothrow_type source[8] = {
+			nothrow_type(0), nothrow_type(1), nothrow_type(2), nothrow_type(3),
+			nothrow_type(4), nothrow_type(5), nothrow_type(6), nothrow_type(7)
+		};
+		int before = counts::live;
+
+		tools::construct(raw, raw + 4, 9);
+		EXPECT(before + 4 == counts::live && 9 == raw[3].value);
+		tools::destroy(raw, raw + 4);
+
+		counts::reset(5);
+		bool threw = false;
+		try {
+			tools::uninitialized_copy(source, source + 8, raw);
+		}
+		catch (std::runtime_error&) {
+			threw = true;
+		}
+		EXPECT(threw && before == counts::live);
+
+		counts::reset();
+		tools::uninitialized_copy(source, source + 8, raw);
+		nothrow_type* end = tools::relocate_backward(raw, raw + 8, raw + 12);
+		EXPECT(raw + 4 == end && values_are(raw + 4, raw + 12, 0) && before + 8 == counts::live);
+		end = tools::relocate(raw + 4, raw + 12, raw + 1);
+		EXPECT(raw + 9 == end && values_are(raw + 1, raw + 9, 0) && 16 == counts::moves);
+		tools::destroy(raw + 1, raw + 9);
+		EXPECT(before == counts::live);
+
+		/* a copy throwing halfway through the gap leaves the source whole */
+		std::allocator<throwing_type> throwing_alloc;
+		throwing_type* from = throwing_alloc.allocate(8);
+		throwing_type* to   = throwing_alloc.allocate(12);
+		for (int i = 0; i < 8; ++i) {
+			tools::construct(from + i, i);
+		}
+		for (int k : { 3, 7 }) {
+			counts::reset(k);
+			threw = false;
+			try {
+				tools::_relocate_with_gap(from, from + 4, from + 8, to, 4);
+			}
+			catch (std::runtime_error&) {
+				threw = true;
+			}
+			EXPECT(threw && 0 == counts::moves && before + 8 == counts::live && values_are(from, from + 8, 0));
+		}
+		counts::reset();
+		throwing_type* last = tools::_relocate_with_gap(from, from + 4, from + 8, to, 4);
+		EXPECT(to + 12 == last && values_are(to, to + 4, 0) && values_are(to + 8, to + 12, 4));
+		EXPECT(before + 8 == counts::live);
+		tools::destroy(to, to + 4);
+		tools::destroy(to + 8, to + 12);
+		EXPECT(before == counts::live);
+
+		throwing_alloc.deallocate(to, 12);
+		throwing_alloc.deallocate(from, 8);
+		alloc.deallocate(raw, 16);
+	}
+
+	/* shifts inside a sequence keep every slot counted once when a move or copy throws */
+	void sequence_shift_safety() {
+		typedef counted<true>  nothrow_type;
+		typedef counted<false> throwing_type;
+
+		{
+			tools::sequence<throwing_type> values;
+			values.reserve(16);
+			for (int i = 0; i < 6; ++i) {
+				values.emplace_back(i);
+			}
+
+			/* single inserts shift by assignment when moves throw */
+			for (int k = 1; k < 8; ++k) {
+				counts::reset(k);
+				try {
+					values.emplace(values.begin() + 2, 100);
+				}
+				catch (std::runtime_error&) {
+				}
+				EXPECT(int(values.size()) == counts::live);
+				values.erase(values.begin() + 6, values.end());
+			}
+			/* the shifted values may be scrambled, the count may not */
+			counts::reset();
+			values.clear();
+			for (int i = 0; i < 6; ++i) {
+				values.emplace_back(i);
+			}
+			values.emplace(values.begin() + 2, 100);
+			EXPECT(values_are(values, { 0, 1, 100, 2, 3, 4, 5 }));
+			values.erase(values.begin() + 2);
+
+			/* a range insert goes through a fresh buffer and is all or nothing */
+			throwing_type more[3] = { throwing_type(7), throwing_type(8), throwing_type(9) };
+			for (int k = 1; k < 8; ++k) {
+				counts::reset(k);
+				try {
+					values.insert(values.begin() + 1, more, more + 3);
+				}
+				catch (std::runtime_error&) {
+					EXPECT(values_are(values, { 0, 1, 2, 3, 4, 5 }));
+				}
+				EXPECT(int(values.size()) + 3 == counts::live);
+				if (9 == values.size()) {
+					EXPECT(values_are(values, { 0, 7, 8, 9, 1, 2, 3, 4, 5 }));
+					values.erase(values.begin() + 1, values.begin() + 4);
+				}
+			}
+
+			/* erasing by assignment leaves a live, shorter or unchanged sequence */
+			for (int k = 1; k < 4; ++k) {
+				counts::reset(k);
+				try {
+					values.erase(values.begin());
+				}
+				catch (std::runtime_error&) {
+				}
+				EXPECT(int(values.size()) + 3 == counts::live);
+			}
+			counts::reset();
+		}
+		EXPECT(0 == counts::live);
+
+		{
+			tools::sequence<nothrow_type> values;
+			values.reserve(16);
+			for (int i = 0; i < 6; ++i) {
+				values.emplace_back(i);
+			}
+
+			/* relocated in place, a throwing copy of the new elements shifts the tail back */
+			nothrow_type more[3] = { nothrow_type(7), nothrow_type(8), nothrow_type(9) };
+			counts::reset(2);
+			try {
+				values.insert(values.begin() + 2, more, more + 3);
+			}
+			catch (std::runtime_error&) {
+			}
+			EXPECT(values_are(values, { 0, 1, 2, 3, 4, 5 }) && 9 == counts::live);
+
+			counts::reset(2);
+			try {
+				values.erase_if([](const nothrow_type& v) {
+					counts::tick();
+					return 0 == v.value % 2;
+				});
+			}
+			catch (std::runtime_error&) {
+			}
+			EXPECT(values_are(values, { 1, 2, 3, 4, 5 }) && 8 == counts::live);
+			counts::reset();
+		}
+		EXPECT(0 == counts::live);
+
+		{
+			/* the throwing column shifts first, the relocating one only once it is done */
+			tools::soa_sequence<nothrow_type, throwing_type> rows;
+			for (int i = 0; i < 6; ++i) {
+				rows.emplace_back(nothrow_type(i), throwing_type(i));
+			}
+			for (int k = 1; k < 4; ++k) {
+				counts::reset(k);
+				try {
+					rows.erase(rows.begin() + 1);
+				}
+				catch (std::runtime_error&) {
+				}
+				EXPECT(int(rows.size()) * 2 == counts::live);
+			}
+			counts::reset();
+			rows.erase(rows.begin());
+			EXPECT(int(rows.size()) * 2 == counts::live);
+		}
+		EXPECT(0 == counts::live);
+	}
+
+	void huge_page_sequences() {
+		tools::huge_page_alloc small_threshold(64 * 1024);
+		EXPECT(100 == small_threshold.good_size(100));
+		EXPECT(size_t(tools::huge_page_alloc::_huge_page_size) == small_threshold.good_size(64 * 1024));
+
+		tools::sequence<int, tools::huge_page_alloc> values(small_threshold);
+		for (int i = 0; i < 1000000; ++i) {
+			values.push_back(i);
+		}
+		EXPECT(1000000 == values.size() && 999999 == values.back() && 4096 == values[4096]);
+		EXPECT(0 == (uintptr_t) values.data() % tools::huge_page_alloc::_huge_page_size);
+
+		/* hugetlbfs pages are rarely reserved, the mapping falls back to transparent pages */
+		tools::huge_page_alloc hugetlbfs(0, true);
+		void* p = hugetlbfs.allocate(100);
+		EXPECT(nullptr != p);
+		hugetlbfs.deallocate(p, 100);
+	}
+
+	void aligned_sequences() {
+		tools::sequence<float, tools::aligned_adaptor<64> > values;
+		for (int i = 0; i < 10000; ++i) {
+			values.push_back(float(i));
+			EXPECT(tools::is_aligned<64>(values.data()));
+		}
+		EXPECT(10000 == values.size() && 9999.0f == values.back());
+
+		tools::sequence<float, tools::aligned_adaptor<64> > copy(values);
+		EXPECT(tools::is_aligned<64>(copy.data()) && 0.0f == copy.front());
+
+		/* aligned blocks carved from an arena */
+		tools::arena region;
+		tools::aligned_adaptor<4096, tools::arena_alloc> page_aligned((tools::arena_alloc(region)));
+		void* page = page_aligned.allocate(100);
+		EXPECT(tools::is_aligned<4096>(page) && &region == page_aligned.upstream().region());
+		page_aligned.deallocate(page, 100);
+	}
+
+	/* moves hand the buffer over and leave the source empty, rvalue pushes never copy */
+	void sequence_moves() {
+		tools::sequence<std::string> names;
+		std::string long_name(100, 'x');
+		const char* buffer = long_name.data();
+		names.push_back(std::move(long_name));
+		names.emplace_back(3, 'y');
+		names.push_back("z");
+		EXPECT(3 == names.size() && buffer == names.front().data() && "yyy" == names[1]);
+
+		const std::string* elements = names.data();
+		tools::sequence<std::string> moved(std::move(names));
+		EXPECT(names.empty() && 0 == names.capacity() && nullptr == names.data());
+		EXPECT(elements == moved.data() && 3 == moved.size());
+
+		tools::sequence<std::string> assigned;
+		assigned.push_back("old");
+		assigned = std::move(moved);
+		EXPECT(moved.empty() && 0 == moved.capacity() && elements == assigned.data());
+
+		moved.push_back("reused");
+		moved.swap(assigned);
+		EXPECT(elements == moved.data() && 1 == assigned.size() && "reused" == assigned[0]);
+		tools::swap(moved, assigned);
+		EXPECT(elements == assigned.data() && "z" == assigned.back());
+
+		/* growing moves the elements across, it never copies them */
+		typedef counted<true> value_type;
+		{
+			tools::sequence<value_type> values;
+			counts::reset();
+			for (int i = 0; i < 100; ++i) {
+				value_type v(i);
+				values.push_back(std::move(v));
+				values.emplace_back(i);
+			}
+			tools::sequence<value_type> taken(std::move(values));
+			values = std::move(taken);
+			EXPECT(0 == counts::copies && 200 == values.size() && 200 == counts::live);
+		}
+		EXPECT(0 == counts::live);
+	}
+
+	/* the capacities a sequence passes through while push_back fills it */
+	template <typename _Sequence>
+	std::vector<size_t> capacities_while_filling(size_t n) {
+		_Sequence values;
+		std::vector<size_t> seen;
+		for (size_t i = 0; i < n; ++i) {
+			values.push_back(typename _Sequence::value_type());
+			if (seen.empty() || seen.back() != values.capacity()) {
+				seen.push_back(values.capacity());
+			}
+		}
+		return seen;
+	}
+
+	/* blocks come back rounded up to whole 4 KiB pages */
+	struct page_rounding_alloc {
+		void* allocate(size_t n) { return ::operator new(n); }
+		void deallocate(void* p, size_t) { ::operator delete(p); }
+		size_t good_size(size_t n) const { return (n + 4095) & ~size_t(4095); }
+	};
+
+	/* reserve and shrink_to_fit set the capacity exactly, each policy grows as documented */
+	void sequence_capacity() {
+		tools::sequence<std::string> names;
+		names.reserve(10);
+		EXPECT(10 == names.capacity() && names.empty());
+		names.push_back("first");
+		const std::string* elements = names.data();
+		names.reserve(5);
+		EXPECT(10 == names.capacity() && elements == names.data());
+		names.reserve(40);
+		EXPECT(40 == names.capacity() && "first" == names[0]);
+
+		names.push_back("second");
+		names.shrink_to_fit();
+		EXPECT(2 == names.capacity() && "second" == names.back());
+		names.clear();
+		names.shrink_to_fit();
+		EXPECT(0 == names.capacity() && nullptr == names.data());
+
+		typedef std::allocator<int> int_alloc;
+		std::vector<size_t> doubling = capacities_while_filling<tools::sequence<int, int_alloc, tools::growth::doubling> >(100);
+		std::vector<size_t> one_and_half = capacities_while_filling<tools::sequence<int, int_alloc, tools::growth::one_and_half> >(100);
+		EXPECT((std::vector<size_t> { 1, 2, 4, 8, 16, 32, 64, 128 }) == doubling);
+		EXPECT((std::vector<size_t> { 1, 2, 3, 4, 6, 9, 13, 19, 28, 42, 63, 94, 141 }) == one_and_half);
+
+		/* one and a half, rounded up to whole pages of uint64_t */
+		typedef tools::sequence<
+			uint64_t, page_rounding_alloc, tools::growth::size_class_aware<tools::growth::one_and_half>
+		> paged_type;
+		EXPECT((std::vector<size_t> { 512, 1024, 1536, 2560 }) == capacities_while_filling<paged_type>(2560));
+	}
+
+	void small_sequence_spill() {
+		typedef tools::small_sequence<std::string, 4> small_type;
+
+		small_type inline_values;
+		for (int i = 0; i < 4; ++i) {
+			inline_values.push_back(std::to_string(i));
+		}
+		EXPECT(4 == inline_values.capacity());
+
+		small_type spilled(inline_values);
+		spilled.insert(spilled.begin(), "front");
+		spilled.emplace_back(30, 'x');
+		EXPECT(6 == spilled.size() && 4 < spilled.capacity());
+		EXPECT("front" == spilled[0] && "3" == spilled[4] && 30 == spilled.back().size());
+
+		/* every pairing of inline and heap storage */
+		small_type moved(std::move(spilled));
+		EXPECT(6 == moved.size() && "front" == moved.front());
+		moved.swap(inline_values);
+		EXPECT(4 == moved.size() && 6 == inline_values.size() && "0" == moved.front());
+		moved = inline_values;
+		EXPECT(6 == moved.size() && "front" == moved.front());
+
+		moved.erase(moved.begin());
+		moved.erase(moved.begin());
+		moved.resize(3);
+		moved.shrink_to_fit();
+		EXPECT(3 == moved.size() && 4 == moved.capacity() && "1" == moved.front());
+	}
+
+	template <typename _T>
+	_T make_value(int i);
+
+	template <>
+	int make_value<int>(int i) { return i; }
+
+	template <>
+	std::string make_value<std::string>(int i) { return std::to_string(i) + std::string(i % 3 * 10, '#'); }
+
+	/* random range, fill and aliasing inserts and erases, mirrored on a std::vector */
+	template <typename _Sequence>
+	bool mirrors_vector(unsigned seed) {
+		typedef typename _Sequence::value_type _T;
+
+		std::mt19937 random(seed);
+		_Sequence values;
+		std::vector<_T> model;
+		bool same = true;
+
+		for (int step = 0; step < 2000 && same; ++step) {
+			size_t pos = model.empty() ? 0 : random() % (model.size() + 1);
+			int n = int(random() % 6);
+			switch (random() % 7) {
+			case 0: { /* forward range */
+				std::vector<_T> more;
+				for (int i = 0; i < n; ++i) {
+					more.push_back(make_value<_T>(step * 10 + i));
+				}
+				values.insert(values.begin() + pos, more.begin(), more.end());
+				model.insert(model.begin() + pos, more.begin(), more.end());
+				break;
+			}
+			case 1: { /* input range, length unknown up front */
+				std::stringstream text;
+				for (int i = 0; i < n; ++i) {
+					text << make_value<_T>(step * 10 + i) << ' ';
+				}
+				values.insert(values.begin() + pos, std::istream_iterator<_T>(text), std::istream_iterator<_T>());
+				text.clear();
+				text.seekg(0);
+				model.insert(model.begin() + pos, std::istream_iterator<_T>(text), std::istream_iterator<_T>());
+				break;
+			}
+			case 2: { /* fill, sometimes from an element of the tail that shifts */
+				if (pos < model.size() && 0 == random() % 2) {
+					size_t from = pos + random() % (model.size() - pos);
+					values.insert(values.begin() + pos, size_t(n), values[from]);
+					model.insert(model.begin() + pos, size_t(n), _T(model[from]));
+				}
+				else {
+					values.insert(values.begin() + pos, size_t(n), make_value<_T>(step));
+					model.insert(model.begin() + pos, size_t(n), make_value<_T>(step));
+				}
+				break;
+			}
+			case 3: { /* erase a range */
+				size_t last = std::min(model.size(), pos + n);
+				values.erase(values.begin() + pos, values.begin() + last);
+				model.erase(model.begin() + pos, model.begin() + last);
+				break;
+			}
+			case 4: { /* erase_if */
+				int mod = 2 + n;
+				size_t gone = values.erase_if([mod](const _T& v) { return 0 == std::hash<_T>()(v) % mod; });
+				size_t before = model.size();
+				model.erase(std::remove_if(model.begin(), model.end(),
+				                           [mod](const _T& v) { return 0 == std::hash<_T>()(v) % mod; }),
+				            model.end());
+				same = before - model.size() == gone;
+				break;
+			}
+			case 5: /* room to shift in place */
+				values.reserve(values.size() + random() % 16);
+				break;
+			default:
+				values.shrink_to_fit();
+				break;
+			}
+			same = same && model.size() == values.size() && std::equal(model.begin(), model.end(), values.begin());
+		}
+		return same;
+	}
+
+	/* range and fill inserts, both in place and through a reallocation, against std::vector */
+	void sequence_ranges() {
+		for (unsigned seed = 1; seed <= 4; ++seed) {
+			EXPECT(mirrors_vector<tools::sequence<int> >(seed));
+			EXPECT(mirrors_vector<tools::sequence<std::string> >(seed));
+		}
+
+		/* n copies of an element that the shift moves */
+		tools::sequence<std::string> names;
+		names.reserve(16);
+		names.push_back("a");
+		names.push_back("b");
+		names.push_back("c");
+		names.insert(names.begin(), 3, names[2]);
+		EXPECT(6 == names.size() && "c" == names[0] && "c" == names[2] && "a" == names[3] && "c" == names[5]);
+		names.insert(names.begin() + 1, 20, names.back());
+		EXPECT(26 == names.size() && "c" == names[20] && "a" == names[23]);
+	}
+
+	/* the same interface on small_sequence, crossing between inline and heap storage */
+	void small_sequence_ranges() {
+		typedef tools::small_sequence<int, 8>         small_ints;
+		typedef tools::small_sequence<std::string, 4> small_strings;
+
+		for (unsigned seed = 1; seed <= 4; ++seed) {
+			EXPECT(mirrors_vector<small_ints>(seed));
+			EXPECT(mirrors_vector<small_strings>(seed));
+		}
+
+		tools::small_sequence<std::string, 8> names;
+		names.push_back("a");
+		names.push_back("b");
+		names.insert(names.begin(), 3, names[1]);
+		EXPECT(names.is_inline() && 5 == names.size() && "b" == names[0] && "a" == names[3]);
+		names.insert(names.begin() + 1, 4, names.back());
+		EXPECT(!names.is_inline() && 9 == names.size() && "a" == names[7]);
+		EXPECT(8 == names.erase_if([](const std::string& v) { return "b" == v; }) && "a" == names.front());
+	}
+
+	/* growth by realloc below the threshold, by mremap above it, one copy across it */
+	void mremap_growth() {
+		tools::sequence<uint64_t, tools::mremap_alloc> values((tools::mremap_alloc(64 * 1024)));
+		for (uint64_t i = 0; i < 1000000; ++i) {
+			values.push_back(i * 3);
+		}
+		bool intact = true;
+		for (uint64_t i = 0; i < values.size(); ++i) {
+			intact = intact && i * 3 == values[i];
+		}
+		EXPECT(1000000 == values.size() && intact);
+
+		values.resize(100);
+		values.shrink_to_fit();
+		EXPECT(100 == values.capacity() && 297 == values.back());
+
+		tools::sequence<std::string, tools::mremap_alloc> strings((tools::mremap_alloc(4096)));
+		for (int i = 0; i < 1000; ++i) {
+			strings.push_back("a string too long for the small string buffer " + std::to_string(i));
+		}
+		EXPECT(1000 == strings.size() && "a string too long for the small string buffer 999" == strings.back());
+	}
+
+	/* every kernel level against the std algorithms, on odd lengths and unaligned starts */
+	void simd_scans() {
+		tools::sequence<int32_t> ints;
+		tools::sequence<float>   floats;
+		for (int i = 0; i < 1000; ++i) {
+			ints.push_back(int32_t((i * 7919) % 2001) - 1000);
+			floats.push_back(float((i * 7919) % 2001) / 8.0f - 100.0f);
+		}
+
+		for (int level = tools::simd_scalar; level <= tools::detected_simd_level(); ++level) {
+			tools::set_simd_level(tools::simd_level(level));
+			for (size_t offset = 0; offset < 9; ++offset) {
+				for (size_t length = 1; length < 100; length += 7) {
+					const int32_t* first = ints.data() + offset;
+					const int32_t* last  = first + length;
+					int64_t expected_sum = 0;
+					for (const int32_t* p = first; p != last; ++p) {
+						expected_sum += *p;
+					}
+
+					EXPECT(std::find(first, last, first[length / 2]) == tools::find(first, last, first[length / 2]));
+					EXPECT(last == tools::find(first, last, 5000));
+					EXPECT(size_t(std::count(first, last, first[0])) == tools::count(first, last, first[0]));
+					EXPECT(*std::min_element(first, last) == tools::min_value(first, last));
+					EXPECT(*std::max_element(first, last) == tools::max_value(first, last));
+					EXPECT(expected_sum == tools::sum(first, last));
+					EXPECT(tools::all_less(first, last, *std::max_element(first, last) + 1));
+					EXPECT(!tools::all_less(first, last, *std::max_element(first, last)));
+
+					const float* ffirst = floats.data() + offset;
+					const float* flast  = ffirst + length;
+					EXPECT(*std::min_element(ffirst, flast) == tools::min_value(ffirst, flast));
+					EXPECT(*std::max_element(ffirst, flast) == tools::max_value(ffirst, flast));
+					EXPECT(size_t(std::count(ffirst, flast, ffirst[0])) == tools::count(ffirst, flast, ffirst[0]));
+				}
+			}
+			EXPECT(tools::sum(ints) == tools::sum(ints.data(), ints.data() + ints.size()));
+			EXPECT(ints.begin() + 10 == tools::find(ints, ints[10]));
+		}
+		tools::set_simd_level(tools::detected_simd_level());
+	}
+
+	/* a small grain cuts the ranges into many chunks over four threads */
+	void parallel_algorithms() {
+		tools::fork_join_pool pool(4);
+		tools::parallel::policy exec(100, pool);
+
+		tools::sequence<int64_t> values;
+		for (int64_t i = 0; i < 100000; ++i) {
+			values.push_back((i * 7919) % 100003 - 50000);
+		}
+
+		tools::sequence<int64_t> doubled(values);
+		tools::parallel::for_each(exec, doubled.begin(), doubled.end(), [](int64_t& x) { x *= 2; });
+		tools::sequence<int64_t> halved(values);
+		tools::parallel::transform(exec, doubled.begin(), doubled.end(), halved.begin(), [](int64_t x) { return x / 2; });
+		EXPECT(std::equal(values.begin(), values.end(), halved.begin()));
+
+		EXPECT(std::accumulate(values.begin(), values.end(), int64_t(0)) ==
+		       tools::parallel::reduce(exec, values.begin(), values.end(), int64_t(0), std::plus<int64_t>()));
+
+		tools::sequence<int64_t> expected(values), scanned(values);
+		std::partial_sum(values.begin(), values.end(), expected.begin());
+		tools::parallel::inclusive_scan(exec, values.begin(), values.end(), scanned.begin(), std::plus<int64_t>());
+		EXPECT(std::equal(expected.begin(), expected.end(), scanned.begin()));
+
+		tools::sequence<int64_t> sorted(values);
+		tools::parallel::sort(exec, sorted.begin(), sorted.end(), std::less<int64_t>());
+		EXPECT(std::is_sorted(sorted.begin(), sorted.end()));
+
+		/* both sides keep their order */
+		tools::sequence<int64_t> split(values);
+		auto even = [](int64_t x) { return 0 == x % 2; };
+		tools::sequence<int64_t>::iterator middle = tools::parallel::partition(exec, split.begin(), split.end(), even);
+		tools::sequence<int64_t> reference(values);
+		std::stable_partition(reference.begin(), reference.end(), even);
+		EXPECT(std::equal(reference.begin(), reference.end(), split.begin()));
+		EXPECT(middle - split.begin() == std::count_if(values.begin(), values.end(), even));
+
+		/* nested runs execute inline on the calling worker */
+		std::atomic<int> nested(0);
+		pool.run(8, [&](size_t) {
+			pool.run(4, [&](size_t) { ++nested; });
+		});
+		EXPECT(32 == nested.load());
+	}
+
+	void soa_columns() {
+		tools::soa_sequence<int, std::string, double> rows;
+		for (int i = 0; i < 1000; ++i) {
+			rows.emplace_back(i, std::to_string(i), i * 0.5);
+		}
+		EXPECT(1000 == rows.size() && "999" == std::get<1>(rows.back()));
+
+		tools::column_span<double> halves = rows.column<2>();
+		EXPECT(1000 == halves.size() && tools::is_aligned<64>(halves.data()));
+		EXPECT(tools::is_aligned<64>(rows.column<0>().data()) && tools::is_aligned<64>(rows.column<1>().data()));
+		EXPECT(499.5 == std::accumulate(halves.begin(), halves.end(), 0.0) / 500);
+
+		rows.erase(rows.begin());
+		EXPECT(999 == rows.size() && 1 == std::get<0>(rows.front()) && "1" == std::get<1>(rows.front()));
+
+		tools::soa_sequence<int, std::string, double> copy(rows);
+		rows.shrink_to_fit();
+		EXPECT(999 == rows.capacity() && "999" == std::get<1>(copy.back()));
+
+		/* size_class_aware growth fills the rounded block with whole rows */
+		tools::basic_soa_sequence<page_rounding_alloc, tools::growth::size_class_aware<>, int, double, char> packed;
+		packed.push_back(1, 1.0, 'a');
+		EXPECT(300 <= packed.capacity() && packed.capacity() < 4096 / 13);
+		for (int i = 0; i < 5000; ++i) {
+			packed.push_back(i, i * 0.25, char(i));
+		}
+		EXPECT(5001 == packed.size() && 4999 == std::get<0>(packed.back()));
+	}
+
+	/* the ring wraps and grows at both ends, checked against std::deque */
+	void deque_ring() {
+		tools::deque<std::string> ring;
+		std::deque<std::string>   reference;
+		for (int i = 0; i < 5000; ++i) {
+			std::string value = std::to_string(i);
+			switch (i * 7 % 5) {
+				case 0: case 1: ring.push_back(value); reference.push_back(value); break;
+				case 2:         ring.push_front(value); reference.push_front(value); break;
+				case 3:         if (!ring.empty()) { ring.pop_front(); reference.pop_front(); } break;
+				default:        if (!ring.empty()) { ring.pop_back(); reference.pop_back(); } break;
+			}
+		}
+		EXPECT(reference.size() == ring.size());
+		EXPECT(std::equal(reference.begin(), reference.end(), ring.begin()));
+		EXPECT(std::equal(reference.rbegin(), reference.rend(), ring.rbegin()));
+
+		tools::deque<std::string> copy(ring);
+		EXPECT(reference.front() == copy[0] && reference.back() == copy.back());
+
+		tools::queue<int> batches;
+		int in[100], out[100];
+		std::iota(in, in + 100, 0);
+		for (int r = 0; r < 50; ++r) {
+			batches.push_n(in, 100);
+			EXPECT(60 == batches.pop_n(out, 60) && 0 == out[0] && 59 == out[59]);
+			EXPECT(40 == batches.pop_n(out, 60) && 60 == out[0]);
+		}
+		EXPECT(batches.empty());
+	}
+
+	/* the elements survive a reopen, a reader follows the writer with refresh() */
+	void mmap_file() {
+		char path[] = "/tmp/tools_mmap_sequence_XXXXXX";
+		int fd = mkstemp(path);
+		EXPECT(-1 != fd);
+		close(fd);
+
+		typedef tools::mmap_sequence<uint64_t>       file_type;
+		typedef tools::mmap_sequence<const uint64_t> reader_type;
+
+		/* a read-only mapping hands out nothing that could write to it */
+		EXPECT((std::is_same<decltype(std::declval<reader_type&>()[0]), const uint64_t&>::value));
+		EXPECT((std::is_same<decltype(*std::declval<reader_type&>().begin()), const uint64_t&>::value));
+		EXPECT((std::is_same<reader_type::value_type, uint64_t>::value));
+		EXPECT(!reader_type::writable() && file_type::writable());
+		{
+			file_type writer(path, file_type::truncate);
+			for (uint64_t i = 0; i < 100000; ++i) {
+				writer.push_back(i * i);
+			}
+			writer.sync();
+
+			reader_type reader(path);
+			EXPECT(100000 == reader.size() && 99999ull * 99999ull == reader.back());
+
+			uint64_t extra[1000];
+			std::iota(extra, extra + 1000, uint64_t(1));
+			writer.append(extra, 1000);
+			writer.erase(writer.begin());
+			writer.sync();
+			reader.refresh();
+			EXPECT(100999 == reader.size() && 1 == reader[0] && 1000 == reader.back());
+		}
+		{
+			file_type reopened(path, file_type::read_write);
+			EXPECT(100999 == reopened.size() && 4 == reopened[1]);
+			reopened.shrink_to_fit();
+			EXPECT(reopened.size() == reopened.capacity());
+		}
+
+		bool threw = false;
+		try {
+			tools::mmap_sequence<const uint32_t> mismatched(path);
+		}
+		catch (std::runtime_error&) {
+			threw = true;
+		}
+		EXPECT(threw);
+
+		threw = false;
+		try {
+			file_type writable_read_only(path, file_type::read_only);
+		}
+		catch (std::invalid_argument&) {
+			threw = true;
+		}
+		EXPECT(threw);
+		std::remove(path);
+	}
+
+	/* every version keeps its contents while later ones share and replace nodes */
+	void persistent_versions() {
+		typedef tools::persistent_vector<std::string> vector_type;
+
+		std::vector<vector_type> versions(1);
+		for (int i = 0; i < 2000; ++i) {
+			versions.push_back(versions.back().push_back(std::to_string(i)));
+		}
+		vector_type edited = versions.back().set(1500, "edited").pop_back();
+
+		bool intact = true;
+		for (size_t v = 0; v < versions.size(); v += 97) {
+			intact = intact && v == versions[v].size();
+			for (size_t i = 0; i < versions[v].size(); ++i) {
+				intact = intact && std::to_string(i) == versions[v][i];
+			}
+		}
+		EXPECT(intact);
+		EXPECT(1999 == edited.size() && "edited" == edited[1500] && "1500" == versions.back()[1500]);
+
+		/* a transient edits in place, then freezes into a new version */
+		tools::transient_vector<std::string> draft = edited.transient();
+		for (int i = 0; i < 1100; ++i) {
+			draft.pop_back();
+		}
+		draft.set(0, "first");
+		draft.push_back("last");
+		vector_type frozen = draft.persistent();
+		draft.push_back("after");
+		EXPECT(900 == frozen.size() && "first" == frozen.front() && "last" == frozen.back());
+		EXPECT(1999 == edited.size() && "0" == edited.front() && "1998" == edited.back());
+		EXPECT(std::equal(frozen.begin(), frozen.end() - 1, draft.begin()));
+
+		bool threw = false;
+		try {
+			frozen.at(900);
+		}
+		catch (std::out_of_range&) {
+			threw = true;
+		}
+		EXPECT(threw);
+	}
+
+	/* handles follow their value through erases and go stale once it is gone */
+	void slot_map_handles() {
+		typedef tools::slot_map<std::string> map_type;
+
+		map_type values;
+		std::vector<map_type::handle_type> handles;
+		for (int i = 0; i < 1000; ++i) {
+			handles.push_back(values.emplace(std::to_string(i)));
+		}
+		for (int i = 0; i < 1000; i += 3) {
+			EXPECT(values.erase(handles[i]));
+		}
+		EXPECT(!values.erase(handles[0]));
+
+		bool follow = true;
+		for (int i = 0; i < 1000; ++i) {
+			const std::string* p = values.find(handles[i]);
+			follow = follow && (0 == i % 3 ? nullptr == p : std::to_string(i) == *p);
+		}
+		EXPECT(follow);
+		EXPECT(666 == values.size());
+
+		/* a reused slot does not answer to the handle of its previous value */
+		map_type::handle_type reused = values.insert("reused");
+		EXPECT(reused.index() == handles[999].index() && !values.contains(handles[999]));
+		EXPECT("reused" == values[reused]);
+
+		bool positions = true;
+		for (size_t i = 0; i < values.size(); ++i) {
+			positions = positions && &values[values.handle_at(i)] == &*(values.begin() + i);
+		}
+		EXPECT(positions);
+
+		values.erase(values.begin());
+		EXPECT(666 == values.size());
+
+		map_type copy = values;
+		values.clear();
+		EXPECT(values.empty() && !values.contains(reused));
+		EXPECT(666 == copy.size() && "reused" == copy.at(reused));
+
+		bool threw = false;
+		try {
+			values.at(reused);
+		}
+		catch (std::out_of_range&) {
+			threw = true;
+		}
+		EXPECT(threw);
+	}
+
+	/* word-at-a-time queries and set operations agree with std::vector<bool> */
+	void bit_sequence_words() {
+		typedef tools::bit_sequence<> bits_type;
+
+		std::vector<bool> model_a, model_b;
+		bits_type a, b;
+		for (int i = 0; i < 1000; ++i) {
+			model_a.push_back(0 == i % 3);
+			a.push_back(0 == i % 3);
+		}
+		for (int i = 0; i < 700; ++i) {
+			model_b.push_back(0 == i % 5 || 0 == i % 7);
+			b.push_back(0 == i % 5 || 0 == i % 7);
+		}
+		EXPECT(size_t(std::count(model_a.begin(), model_a.end(), true)) == a.count());
+		EXPECT(std::equal(model_a.begin(), model_a.end(), a.begin()));
+
+		bits_type both = a, either = a, only = a;
+		both &= b;
+		either |= b;
+		only -= b;
+		bool combined = 1000 == either.size();
+		for (size_t i = 0; i < 1000; ++i) {
+			bool in_b = i < model_b.size() && model_b[i];
+			combined = combined && (model_a[i] && in_b) == both.test(i)
+			                    && (model_a[i] || in_b) == either.test(i)
+			                    && (model_a[i] && !in_b) == only.test(i);
+		}
+		EXPECT(combined);
+
+		size_t visited = 0;
+		bool ordered = true;
+		for (size_t i = only.find_first(); bits_type::npos != i; i = only.find_next(i)) {
+			ordered = ordered && model_a[i] && !(i < model_b.size() && model_b[i]);
+			++visited;
+		}
+		EXPECT(ordered && visited == only.count());
+
+		/* growing with set bits and shrinking again leaves nothing past size() */
+		a.resize(1030, true);
+		EXPECT(a.test(1029) && a.count() == 334 + 30);
+		a.resize(999);
+		a.flip();
+		EXPECT(999 - 333 == a.count());
+		a.set();
+		EXPECT(a.all() && 999 == a.count());
+		a.pop_back();
+		a.reset();
+		EXPECT(a.none() && 998 == a.size());
+
+		bits_type ids;
+		EXPECT(ids.insert(4000) && !ids.insert(4000) && ids.contains(4000));
+		EXPECT(4001 == ids.size() && 1 == ids.count());
+		EXPECT(ids.erase(4000) && !ids.erase(4000) && !ids.contains(9000));
+	}
+
+	/* blocks and tail decode to what was pushed, lower_bound agrees with std */
+	void packed_int_blocks() {
+		tools::packed_int_sequence<> packed;
+		std::vector<uint64_t> model;
+		uint64_t value = 0;
+		for (int i = 0; i < 5000; ++i) {
+			/* runs of repeats, small gaps and the odd huge jump give blocks of every width */
+			value += 0 == i % 700 ? uint64_t(1) << 40 : uint64_t(i % 4) * (i % 37);
+			packed.push_back(value);
+			model.push_back(value);
+		}
+		EXPECT(model.size() == packed.size() && model.back() == packed.back());
+		EXPECT(std::equal(model.begin(), model.end(), packed.begin()));
+
+		bool indexed = true;
+		for (size_t i = 0; i < model.size(); i += 7) {
+			indexed = indexed && model[i] == packed[i];
+		}
+		EXPECT(indexed);
+
+		bool bounds = true;
+		for (size_t i = 0; i < model.size(); i += 13) {
+			for (uint64_t probe : { model[i] - 1, model[i], model[i] + 1 }) {
+				size_t expected = std::lower_bound(model.begin(), model.end(), probe) - model.begin();
+				bounds = bounds && expected == packed.lower_bound(probe);
+			}
+		}
+		EXPECT(bounds && packed.size() == packed.lower_bound(value + 1));
+		EXPECT(packed.contains(model[2500]) && !packed.contains(value + 1));
+		EXPECT(packed.memory_usage() < model.size() * sizeof (uint64_t));
+
+		bool threw = false;
+		try {
+			packed.push_back(value - 1);
+		}
+		catch (std::invalid_argument&) {
+			threw = true;
+		}
+		EXPECT(threw && model.size() == packed.size());
+
+		tools::packed_int_sequence<> copy = packed, other;
+		other.push_back(7);
+		other.swap(copy);
+		EXPECT(1 == copy.size() && 7 == copy.front());
+		EXPECT(std::equal(model.begin(), model.end(), other.begin()));
+		copy.swap(other);
+		EXPECT(1 == other.size() && 7 == other.back() && model.back() == copy.back());
+		EXPECT(std::equal(model.begin(), model.end(), copy.begin()));
+		packed.clear();
+		EXPECT(packed.empty() && packed.begin() == packed.end());
+	}
+
+	/* both sorts agree with std::sort on the inputs pdqsort special-cases */
+	void sort_patterns() {
+		std::mt19937 random(42);
+		std::vector<std::vector<int> > inputs(5);
+		for (int i = 0; i < 20000; ++i) {
+			inputs[0].push_back(int(random()));
+			inputs[1].push_back(i);
+			inputs[2].push_back(20000 - i);
+			inputs[3].push_back(int(random() % 8) - 4);
+			inputs[4].push_back(0 == i % 100 ? int(random()) : i);
+		}
+
+		bool sorted = true;
+		for (const std::vector<int>& input : inputs) {
+			std::vector<int> expected = input, quick = input, radix = input, descending = input;
+			std::sort(expected.begin(), expected.end());
+			tools::sort(quick.begin(), quick.end());
+			tools::radix_sort(radix.begin(), radix.end());
+			tools::sort(descending.begin(), descending.end(), tools::larger<int>());
+			sorted = sorted && expected == quick && expected == radix &&
+			         std::equal(expected.rbegin(), expected.rend(), descending.begin());
+		}
+		EXPECT(sorted);
+
+		/* a comparator the branchless path does not take */
+		std::vector<std::string> words;
+		for (int i = 0; i < 3000; ++i) {
+			words.push_back(std::to_string(random() % 500));
+		}
+		std::vector<std::string> expected_words = words;
+		std::sort(expected_words.begin(), expected_words.end());
+		tools::sort(words.begin(), words.end(), tools::less<std::string>());
+		EXPECT(expected_words == words);
+
+		/* radix_sort orders negative doubles and keeps equal keys in input order */
+		std::vector<std::pair<double, int> > keyed;
+		for (int i = 0; i < 5000; ++i) {
+			keyed.push_back(std::make_pair(double(int(random() % 200) - 100) / 4, i));
+		}
+		std::vector<std::pair<double, int> > expected_keyed = keyed;
+		std::stable_sort(expected_keyed.begin(), expected_keyed.end(),
+		                 [](const std::pair<double, int>& l, const std::pair<double, int>& r) { return l.first < r.first; });
+		tools::radix_sort(keyed.begin(), keyed.end(), [](const std::pair<double, int>& p) { return p.first; });
+		EXPECT(expected_keyed == keyed);
+
+		tools::sequence<int64_t> wide;
+		for (int i = 0; i < 1000; ++i) {
+			wide.push_back(int64_t(random()) * (0 == i % 2 ? -1048576 : 1048576));
+		}
+		tools::radix_sort(wide.begin(), wide.end());
+		EXPECT(std::is_sorted(wide.begin(), wide.end()));
+
+		/* priority_queue pops through the heap fixed alongside the sort */
+		tools::priority_queue<int> queue(inputs[0].begin(), inputs[0].begin() + 500);
+		for (int i = 500; i < 1000; ++i) {
+			queue.push(inputs[0][i]);
+		}
+		std::vector<int> popped;
+		while (!queue.empty()) {
+			popped.push_back(queue.top());
+			queue.pop();
+		}
+		EXPECT(1000 == popped.size() && std::is_sorted(popped.rbegin(), popped.rend()));
+	}
+
+	/* inserts and erases interleaved over many rehashes agree with std::map */
+	void flat_hash_churn() {
+		typedef tools::flat_hash_map<std::string, int> map_type;
+
+		std::mt19937 random(7);
+		map_type table;
+		std::map<std::string, int> model;
+		for (int i = 0; i < 20000; ++i) {
+			std::string key = std::to_string(random() % 3000);
+			if (0 == random() % 3) {
+				EXPECT(model.erase(key) == table.erase(key));
+			}
+			else {
+				model[key] += i;
+				table[key] += i;
+			}
+		}
+		EXPECT(model.size() == table.size() && table.load_factor() <= 1.0f);
+
+		bool agree = true;
+		for (const std::pair<const std::string, int>& entry : model) {
+			map_type::iterator it = table.find(entry.first);
+			agree = agree && table.end() != it && entry.second == it->second;
+		}
+		size_t visited = 0;
+		for (const std::pair<std::string, int>& entry : table) {
+			agree = agree && 1 == model.count(entry.first);
+			++visited;
+		}
+		EXPECT(agree && model.size() == visited);
+
+		/* string keys are found from a C string through the transparent hasher */
+		const char* probe = model.begin()->first.c_str();
+		EXPECT(table.contains(probe) && 1 == table.count(probe) && table.find(probe) == table.find(model.begin()->first));
+
+		table.erase(table.find(model.begin()->first));
+		EXPECT(!table.contains(model.begin()->first) && model.size() - 1 == table.size());
+
+		EXPECT("fresh" == table.try_emplace("fresh", 1).first->first && !table.try_emplace("fresh", 2).second);
+		EXPECT(!table.insert_or_assign("fresh", 3).second && 3 == table.at("fresh"));
+
+		bool threw = false;
+		try {
+			table.at("missing");
+		}
+		catch (std::out_of_range&) {
+			threw = true;
+		}
+		EXPECT(threw);
+
+		map_type copy = table;
+		table.clear();
+		EXPECT(table.empty() && table.begin() == table.end() && 3 == copy.at("fresh"));
+		copy.shrink_to_fit();
+		EXPECT(model.size() == copy.size() && 3 == copy["fresh"]);
+
+		/* reserve makes room up front, no rehash while filling it */
+		tools::flat_hash_set<uint64_t> ids;
+		ids.reserve(5000);
+		size_t capacity = ids.capacity();
+		for (uint64_t i = 0; i < 5000; ++i) {
+			ids.insert(i * 0x9e3779b97f4a7c15ull);
+		}
+		EXPECT(capacity == ids.capacity() && 5000 == ids.size() && ids.contains(42 * 0x9e3779b97f4a7c15ull));
+	}
+
+	/* bulk and single inserts keep the values sorted with the first of equal keys */
+	void flat_map_order() {
+		typedef tools::flat_map<int, int> map_type;
+
+		std::mt19937 random(11);
+		std::vector<std::pair<int, int> > batch;
+		for (int i = 0; i < 5000; ++i) {
+			batch.push_back(std::make_pair(int(random() % 2000) - 1000, i));
+		}
+
+		map_type table(batch.begin(), batch.begin() + 2500);
+		std::map<int, int> model(batch.begin(), batch.begin() + 2500);
+		table.insert(batch.begin() + 2500, batch.end());
+		model.insert(batch.begin() + 2500, batch.end());
+		for (int i = 0; i < 200; ++i) {
+			int key = int(random() % 3000) - 1500;
+			EXPECT(model.insert(std::make_pair(key, -i)).second == table.insert(std::make_pair(key, -i)).second);
+		}
+		EXPECT(model.size() == table.size() &&
+		       std::equal(model.begin(), model.end(), table.begin(),
+		                  [](const std::pair<const int, int>& l, const std::pair<int, int>& r) { return l.first == r.first && l.second == r.second; }));
+
+		bool bounds = true;
+		for (int key = -1600; key < 1600; key += 7) {
+			bounds = bounds && std::distance(model.begin(), model.lower_bound(key)) == table.lower_bound(key) - table.begin()
+			                && std::distance(model.begin(), model.upper_bound(key)) == table.upper_bound(key) - table.begin()
+			                && model.count(key) == table.count(key);
+		}
+		EXPECT(bounds);
+		EXPECT(model.begin()->first == table.minimum()->first && model.rbegin()->first == table.maximum()->first);
+
+		int key = model.begin()->first;
+		EXPECT(1 == table.erase(key) && !table.contains(key) && 0 == table.erase(key));
+		EXPECT(!table.try_emplace(model.rbegin()->first, 0).second && table.try_emplace(key, 5).second);
+		EXPECT(!table.insert_or_assign(key, 6).second && 6 == table.at(key) && 6 == table[key]);
+
+		bool threw = false;
+		try {
+			table.at(5000);
+		}
+		catch (std::out_of_range&) {
+			threw = true;
+		}
+		EXPECT(threw);
+
+		/* equal keys stay in insertion order, also when merged in bulk */
+		tools::flat_set<std::string> words = { "pear", "apple", "fig", "apple" };
+		EXPECT(3 == words.size() && "apple" == *words.begin() && "pear" == *words.maximum());
+		map_type equal;
+		equal.insert_equal(std::make_pair(1, 0));
+		equal.insert_equal(batch.begin(), batch.end());
+		equal.insert_equal(std::make_pair(1, 5000));
+		bool stable = 5002 == equal.size();
+		for (map_type::const_iterator it = equal.begin() + 1; it != equal.end(); ++it) {
+			stable = stable && ((it - 1)->first < it->first || (it - 1)->second < it->second);
+		}
+		EXPECT(stable);
+	}
+
+	struct test_entry {
+		const char* name;
+		void      (*run)();
+	};
+
+	const test_entry tests[] = {
+		{ "pool_alloc_lists",        pool_alloc_lists         },
+		{ "pool_alloc_threads",      pool_alloc_threads       },
+		{ "arena_region",            arena_region             },
+		{ "arena_scopes",            arena_scopes             },
+		{ "memory_resources",        memory_resources         },
+		{ "thread_cache_handoff",    thread_cache_handoff     },
+		{ "alloc_stats_counts",      alloc_stats_counts       },
+		{ "memory_helpers",          memory_helpers           },
+		{ "sequence_shift_safety",   sequence_shift_safety    },
+		{ "huge_page_sequences",     huge_page_sequences      },
+		{ "aligned_sequences",       aligned_sequences        },
+		{ "sequence_moves",          sequence_moves           },
+		{ "sequence_capacity",       sequence_capacity        },
+		{ "small_sequence_spill",    small_sequence_spill     },
+		{ "sequence_ranges",         sequence_ranges          },
+		{ "small_sequence_ranges",   small_sequence_ranges    },
+		{ "mremap_growth",           mremap_growth            },
+		{ "simd_scans",              simd_scans               },
+		{ "parallel_algorithms",     parallel_algorithms      },
+		{ "soa_columns",             soa_columns              },
+		{ "deque_ring",              deque_ring               },
+		{ "mmap_file",               mmap_file                },
+		{ "persistent_versions",     persistent_versions      },
+		{ "slot_map_handles",        slot_map_handles         },
+		{ "bit_sequence_words",      bit_sequence_words       },
+		{ "packed_int_blocks",       packed_int_blocks        },
+		{ "sort_patterns",           sort_patterns            },
+		{ "flat_hash_churn",         flat_hash_churn          },
+		{ "flat_map_order",          flat_map_order           },
+	};
+}
+
+int main(int argc, char* argv[]) {
+	for (const test_entry& entry : tests) {
+		bool selected = 1 == argc;
+		for (int i = 1; i < argc; ++i) {
+			selected = selected || 0 == strcmp(argv[i], entry.name);
+		}
+		if (selected) {
+			int before = failures;
+			entry.run();
+			std::cout << entry.name << (before == failures ? ": ok" : ": FAILED") << std::endl;
+		}
+	}
+	return 0 == failures ? 0 : 1;
+}
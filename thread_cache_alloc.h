@@ -0,0 +1,275 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _THREAD_CACHE_ALLOC_H_
+#define _THREAD_CACHE_ALLOC_H_
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace tools {
+
+	/*
+	 * Magazine allocator: every thread caches free blocks of each size
+	 * class in two magazines and only takes the depot lock to trade a
+	 * whole magazine, full for empty or the other way round. Blocks are
+	 * carved from chunks that stay with the depot until exit.
+	 */
+	class thread_cache_alloc {
+	public:
+		enum {
+			_align         = 16,
+			_max_bytes     = 256,
+			_num_classes   = _max_bytes / _align,
+			_magazine_size = 64
+		};
+
+	private:
+		struct _magazine {
+			_magazine* next;
+			size_t     count;
+			void*      rounds[_magazine_size];
+		};
+
+		struct _chunk {
+			_chunk* next;
+		};
+
+		struct _depot_class {
+			std::mutex lock;
+			_magazine* loaded; /* magazines holding at least one block */
+			_magazine* empty;
+		};
+
+		class _depot {
+		private:
+			_depot_class m_classes[_num_classes];
+			std::mutex   m_chunk_lock;
+			_chunk*      m_chunks;
+
+		public:
+			_depot() : m_chunks(nullptr) {
+				for (size_t i = 0; i < _num_classes; ++i) {
+					m_classes[i].loaded = nullptr;
+					m_classes[i].empty  = nullptr;
+				}
+			}
+
+			~_depot() {
+				for (size_t i = 0; i < _num_classes; ++i) {
+					_release(m_classes[i].loaded);
+					_release(m_classes[i].empty);
+				}
+				while (nullptr != m_chunks) {
+					_chunk* next = m_chunks->next;
+					::operator delete(m_chunks);
+					m_chunks = next;
+				}
+			}
+
+			/* swaps an empty magazine for a loaded one, nullptr if there is none */
+			_magazine* exchange_empty(size_t index, _magazine* empty) {
+				_depot_class& dc = m_classes[index];
+				std::lock_guard<std::mutex> guard(dc.lock);
+
+				_magazine* loaded = dc.loaded;
+				if (nullptr != loaded) {
+					dc.loaded = loaded->next;
+					if (nullptr != empty) {
+						empty->next = dc.empty;
+						dc.empty = empty;
+					}
+				}
+				return loaded;
+			}
+
+			/* swaps a full magazine for an empty one */
+			_magazine* exchange_full(size_t index, _magazine* full) {
+				_depot_class& dc = m_classes[index];
+				_magazine* empty = nullptr;
+				{
+					std::lock_guard<std::mutex> guard(dc.lock);
+					full->next = dc.loaded;
+					dc.loaded = full;
+
+					empty = dc.empty;
+					if (nullptr != empty) {
+						dc.empty = empty->next;
+					}
+				}
+				return nullptr != empty ? empty : _new_magazine();
+			}
+
+			void put(size_t index, _magazine* mag) {
+				if (nullptr == mag) {
+					return;
+				}
+
+				_depot_class& dc = m_classes[index];
+				std::lock_guard<std::mutex> guard(dc.lock);
+				if (0 == mag->count) {
+					mag->next = dc.empty;
+					dc.empty = mag;
+				}
+				else {
+					mag->next = dc.loaded;
+					dc.loaded = mag;
+				}
+			}
+
+			/* fills an empty magazine with fresh blocks */
+			void carve(size_t index, _magazine* mag) {
+				const size_t block = _block_size(index);
+				_chunk* chunk = (_chunk*) ::operator new(_header_size() + block * _magazine_size);
+				{
+					std::lock_guard<std::mutex> guard(m_chunk_lock);
+					chunk->next = m_chunks;
+					m_chunks = chunk;
+				}
+
+				char* p = (char*) chunk + _header_size();
+				for (size_t i = 0; i < _magazine_size; ++i, p += block) {
+					mag->rounds[i] = p;
+				}
+				mag->count = _magazine_size;
+			}
+
+		private:
+			static void _release(_magazine* mag) {
+				while (nullptr != mag) {
+					_magazine* next = mag->next;
+					::operator delete(mag);
+					mag = next;
+				}
+			}
+		};
+
+		struct _cache {
+			_magazine* loaded[_num_classes];
+			_magazine* previous[_num_classes];
+
+			_cache() {
+				for (size_t i = 0; i < _num_classes; ++i) {
+					loaded[i]   = nullptr;
+					previous[i] = nullptr;
+				}
+			}
+
+			~_cache() {
+				for (size_t i = 0; i < _num_classes; ++i) {
+					_depot_instance().put(i, loaded[i]);
+					_depot_instance().put(i, previous[i]);
+				}
+			}
+		};
+
+	private:
+		static size_t _index_of(size_t n) { return 0 == n ? 0 : (n - 1) / _align; }
+		static size_t _block_size(size_t index) { return (index + 1) * _align; }
+
+		static size_t _header_size() {
+			return (sizeof (_chunk) + _align - 1) & ~size_t(_align - 1);
+		}
+
+		static _magazine* _new_magazine() {
+			_magazine* mag = (_magazine*) ::operator new(sizeof (_magazine));
+			mag->next  = nullptr;
+			mag->count = 0;
+			return mag;
+		}
+
+		static _depot& _depot_instance() {
+			static _depot depot;
+			return depot;
+		}
+
+		static _cache& _thread_cache() {
+			/* the depot must outlive every cache */
+			_depot_instance();
+			static thread_local _cache cache;
+			return cache;
+		}
+
+		static void _swap(_magazine*& left, _magazine*& right) {
+			_magazine* tmp = left;
+			left  = right;
+			right = tmp;
+		}
+
+	public:
+		static void* allocate(size_t n) {
+			if (_max_bytes < n) {
+				return ::operator new(n);
+			}
+
+			size_t index = _index_of(n);
+			_cache& cache = _thread_cache();
+			_magazine*& loaded   = cache.loaded[index];
+			_magazine*& previous = cache.previous[index];
+
+			if (nullptr == loaded) {
+				loaded = _new_magazine();
+			}
+
+			if (0 == loaded->count) {
+				if (nullptr != previous && 0 != previous->count) {
+					_swap(loaded, previous);
+				}
+				else {
+					_magazine* full = _depot_instance().exchange_empty(index, previous);
+					if (nullptr != full) {
+						previous = loaded;
+						loaded   = full;
+					}
+					else {
+						_depot_instance().carve(index, loaded);
+					}
+				}
+			}
+
+			return loaded->rounds[--loaded->count];
+		}
+
+		static size_t good_size(size_t n) {
+			return _max_bytes < n ? n : _block_size(_index_of(n));
+		}
+
+		static void deallocate(void* p, size_t n) {
+			if (nullptr == p) {
+				return;
+			}
+
+			if (_max_bytes < n) {
+				::operator delete(p);
+				return;
+			}
+
+			size_t index = _index_of(n);
+			_cache& cache = _thread_cache();
+			_magazine*& loaded   = cache.loaded[index];
+			_magazine*& previous = cache.previous[index];
+
+			if (nullptr == loaded) {
+				loaded = _new_magazine();
+			}
+
+			if (_magazine_size == loaded->count) {
+				if (nullptr != previous && 0 == previous->count) {
+					_swap(loaded, previous);
+				}
+				else {
+					_magazine* empty = nullptr != previous ?
+						_depot_instance().exchange_full(index, previous) : _new_magazine();
+					previous = loaded;
+					loaded   = empty;
+				}
+			}
+
+			loaded->rounds[loaded->count++] = p;
+		}
+	};
+}
+
+#endif //_THREAD_CACHE_ALLOC_H_
@@ -0,0 +1,185 @@
+/*
+ * Created by Maou Lim on 2026/10/18.
+ */
+
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "sequence.h"
+
+namespace tools {
+
+	/*
+	 * Fork-join pool: run(n, fn) calls fn(0) ... fn(n - 1) spread over the
+	 * workers and the calling thread, and returns once every call did.
+	 * Tasks are handed out through an atomic counter, so uneven ones
+	 * balance themselves. The first exception thrown by a task is
+	 * rethrown from run. run from inside a task executes inline, and
+	 * runs from different threads take turns.
+	 */
+	class fork_join_pool {
+	private:
+		struct _job {
+			void (*invoke)(void*, size_t);
+			void*               context;
+			size_t              count;
+			std::atomic<size_t> next;
+			std::atomic<size_t> finished;
+			std::exception_ptr  error;
+			std::mutex          error_lock;
+		};
+
+	private:
+		sequence<std::thread>   m_workers;
+		std::mutex              m_lock;
+		std::mutex              m_run_lock;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		_job*                   m_job;
+		size_t                  m_generation;
+		size_t                  m_active;     /* workers holding m_job */
+		bool                    m_stop;
+
+	private:
+		static bool& _inside_task() {
+			static thread_local bool inside = false;
+			return inside;
+		}
+
+		template <typename _Function>
+		static void _invoke(void* context, size_t index) {
+			(*(_Function*) context)(index);
+		}
+
+		static void _work_on(_job& job) {
+			bool& inside = _inside_task();
+			bool was_inside = inside;
+			inside = true;
+
+			size_t index;
+			while ((index = job.next.fetch_add(1)) < job.count) {
+				try {
+					job.invoke(job.context, index);
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> guard(job.error_lock);
+					if (!job.error) {
+						job.error = std::current_exception();
+					}
+				}
+				job.finished.fetch_add(1);
+			}
+
+			inside = was_inside;
+		}
+
+		void _worker_loop() {
+			size_t seen = 0;
+			std::unique_lock<std::mutex> guard(m_lock);
+			while (true) {
+				m_wake.wait(guard, [&] { return m_stop || seen != m_generation; });
+				if (m_stop) {
+					return;
+				}
+
+				seen = m_generation;
+				_job* job = m_job;
+				if (nullptr == job) {
+					continue;
+				}
+
+				++m_active;
+				guard.unlock();
+				_work_on(*job);
+				guard.lock();
+				if (0 == --m_active) {
+					m_done.notify_all();
+				}
+			}
+		}
+
+	public:
+		/* threads counts the caller, a pool of one runs everything inline */
+		explicit fork_join_pool(size_t threads = std::thread::hardware_concurrency()) :
+			m_job(nullptr), m_generation(0), m_active(0), m_stop(false) {
+			for (size_t i = 1; i < threads; ++i) {
+				m_workers.emplace_back([this] { _worker_loop(); });
+			}
+		}
+
+		fork_join_pool(const fork_join_pool&) = delete;
+		fork_join_pool& operator=(const fork_join_pool&) = delete;
+
+		~fork_join_pool() {
+			{
+				std::lock_guard<std::mutex> guard(m_lock);
+				m_stop = true;
+			}
+			m_wake.notify_all();
+			for (std::thread& worker : m_workers) {
+				worker.join();
+			}
+		}
+
+	public:
+		/* the process wide pool, one thread per core */
+		static fork_join_pool& instance() {
+			static fork_join_pool pool;
+			return pool;
+		}
+
+		size_t concurrency() const { return m_workers.size() + 1; }
+
+		template <typename _Function>
+		void run(size_t count, _Function fn) {
+			if (0 == count) {
+				return;
+			}
+
+			if (1 == count || m_workers.empty() || _inside_task()) {
+				for (size_t i = 0; i < count; ++i) {
+					fn(i);
+				}
+				return;
+			}
+
+			std::lock_guard<std::mutex> run_guard(m_run_lock);
+
+			_job job;
+			job.invoke  = &_invoke<_Function>;
+			job.context = &fn;
+			job.count   = count;
+			job.next     = 0;
+			job.finished = 0;
+
+			{
+				std::lock_guard<std::mutex> guard(m_lock);
+				m_job = &job;
+				++m_generation;
+			}
+			m_wake.notify_all();
+
+			_work_on(job);
+
+			{
+				std::unique_lock<std::mutex> guard(m_lock);
+				/* no worker may still look at job once it goes out of scope */
+				m_done.wait(guard, [&] { return count == job.finished && 0 == m_active; });
+				m_job = nullptr;
+			}
+
+			if (job.error) {
+				std::rethrow_exception(job.error);
+			}
+		}
+	};
+}
+
+#endif //_THREAD_POOL_H_
@@ -6,8 +6,10 @@
 #define _TREE_BASE_H_
 
 #include <cassert>
+#include <stdexcept>
 
 #include "iterator.h"
+#include "memory.h"
 
 namespace tools {
 
@@ -330,7 +332,7 @@ namespace tools {
 		typename _Order     = traversal::inorder,
 		typename _Allocator = std::allocator<_Node>
 	>
-	class _bitree_base {
+	class _bitree_base : private standard_alloc<_Node, _Allocator> {
 	protected:
 		typedef _Node      node_type;
 		typedef _Order     order_type;
@@ -394,6 +396,13 @@ namespace tools {
 			if (empty()) {
 				return;
 			}
+
+			if (_trivial_teardown<value_type, _Allocator>::value) {
+				root() = nullptr;
+				count  = 0;
+				_locate_boundary();
+				return;
+			}
 			_erase(root());
 		}
 
@@ -557,10 +566,13 @@ namespace tools {
 		}
 
 	public:
-		_bitree_base() : count(0) { _initialize(); }
+		explicit _bitree_base(const _Allocator& alloc = _Allocator()) :
+			allocator_type(alloc), count(0) { _initialize(); }
 		~_bitree_base() { _clear(); put_node(header); }
 
 	public:
+		_Allocator get_allocator() const { return allocator_type::get_allocator(); }
+
 		bool empty() const { return 0 == count; }
 		size_type size() const { return count; }
 		size_type max_size() const { return size_type(-1); }
@@ -720,8 +732,9 @@ namespace tools {
 		link_type& last() const { return base_type::last(); }
 
 	public:
-		explicit _bstree_base(const comparator_type& comp = _Comparator()) :
-			comparator(comp) { }
+		explicit _bstree_base(const comparator_type& comp  = _Comparator(),
+		                      const _Allocator&      alloc = _Allocator()) :
+			base_type(alloc), comparator(comp) { }
 
 	protected:
 		typedef typename base_type::inner_iterator       inner_iterator;
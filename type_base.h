@@ -5,6 +5,8 @@
 #ifndef _TYPE_BASE_H_
 #define _TYPE_BASE_H_
 
+#include <type_traits>
+
 namespace tools {
 
 	/* _true or _false */
@@ -74,6 +76,42 @@ namespace tools {
 	template <typename _Tp>
 	struct _is_identity : _true_type { };
 
+	/* _void_t */
+
+	template <typename...>
+	struct _make_void {
+		typedef void type;
+	};
+
+	template <typename... _Tps>
+	using _void_t = typename _make_void<_Tps...>::type;
+
+	/* _bool_type */
+
+	template <bool _Cond>
+	struct _bool_type : _false_type { };
+
+	template <>
+	struct _bool_type<true> : _true_type { };
+
+	/* type properties */
+
+	template <typename _Tp>
+	struct _is_trivially_destructible :
+		_bool_type<std::is_trivially_destructible<_Tp>::value> { };
+
+	template <typename _Tp>
+	struct _is_trivially_copyable :
+		_bool_type<std::is_trivially_copyable<_Tp>::value> { };
+
+	/*
+	 * moving the bytes to a new address and forgetting the old ones is
+	 * equivalent to move construction plus destruction. specialize it for
+	 * types that hold no pointers into themselves.
+	 */
+	template <typename _Tp>
+	struct _is_trivially_relocatable : _is_trivially_copyable<_Tp> { };
+
 }
 
 #endif //_TYPE_BASE_H_